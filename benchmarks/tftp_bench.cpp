@@ -0,0 +1,636 @@
+/* Copyright (C) 2025 Kevin Exton (kevin.exton@pm.me)
+ *
+ * tftp is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tftp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tftp.  If not, see <https://www.gnu.org/licenses/>.
+ */
+/**
+ * @file tftp_bench.cpp
+ * @brief Microbenchmarks and a loopback throughput harness.
+ */
+// NOLINTBEGIN
+// TFTP_SERVER_STATIC_TEST exposes the static functions in tftp.cpp
+// (insert_data, send_next) for the microbenchmarks, the same way
+// tests/test_tftp_static.cpp does.
+#define TFTP_SERVER_STATIC_TEST
+
+#include "tftp/filesystem.hpp"
+#include "tftp/protocol/tftp_protocol.hpp"
+#include "tftp/protocol/tftp_session.hpp"
+#include "tftp/tftp_client.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// Include the implementation to get access to static functions
+#include "../src/tftp.cpp"
+
+using namespace tftp;
+
+namespace {
+
+auto make_payload(std::size_t size, std::size_t newline_every = 0)
+    -> std::vector<char>
+{
+  auto payload = std::vector<char>(size, 'a');
+  if (newline_every)
+  {
+    for (std::size_t i = newline_every - 1; i < size; i += newline_every)
+      payload[i] = '\n';
+  }
+  return payload;
+}
+
+auto create_bench_file(const std::vector<char> &payload)
+    -> std::filesystem::path
+{
+  const auto path = filesystem::tmpname();
+  std::ofstream(path, std::ios::binary)
+      .write(payload.data(), static_cast<std::streamsize>(payload.size()));
+  return path;
+}
+
+// =============================================================================
+// insert_data microbenchmarks
+// =============================================================================
+void BM_InsertDataOctet(benchmark::State &state)
+{
+  const auto payload =
+      make_payload(static_cast<std::size_t>(state.range(0)));
+  auto buffer = std::vector<char>();
+  buffer.reserve(2 * payload.size());
+
+  for (auto _ : state)
+  {
+    buffer.clear();
+    buffer.resize(sizeof(messages::data));
+    insert_data(buffer, payload, messages::OCTET);
+    benchmark::DoNotOptimize(buffer.data());
+  }
+
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations()) *
+                          static_cast<std::int64_t>(payload.size()));
+}
+BENCHMARK(BM_InsertDataOctet)->Arg(512)->Arg(8192)->Arg(65464);
+
+void BM_InsertDataNetascii(benchmark::State &state)
+{
+  const auto payload =
+      make_payload(static_cast<std::size_t>(state.range(0)), 64);
+  auto buffer = std::vector<char>();
+  buffer.reserve(2 * payload.size());
+
+  for (auto _ : state)
+  {
+    buffer.clear();
+    buffer.resize(sizeof(messages::data));
+    insert_data(buffer, payload, messages::NETASCII);
+    benchmark::DoNotOptimize(buffer.data());
+  }
+
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations()) *
+                          static_cast<std::int64_t>(payload.size()));
+}
+BENCHMARK(BM_InsertDataNetascii)->Arg(512)->Arg(8192)->Arg(65464);
+
+// =============================================================================
+// send_next microbenchmarks
+// =============================================================================
+void BM_SendNextOctetMap(benchmark::State &state)
+{
+  const auto payload = make_payload(64 * messages::DATALEN);
+  const auto path = create_bench_file(payload);
+
+  auto err = std::error_code();
+  auto session = session_t();
+  session.state.mode = messages::OCTET;
+  session.state.map = filesystem::open_map(path, err);
+
+  for (auto _ : state)
+  {
+    if (!session.state.read_pending())
+    {
+      session.state.map_offset = 0;
+      session.state.map_eof = false;
+      session.state.block_num = 0;
+      session.state.buffer.clear();
+    }
+    benchmark::DoNotOptimize(send_next(&session));
+  }
+
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations()) *
+                          static_cast<std::int64_t>(messages::DATALEN));
+  session.state.map.reset();
+  std::filesystem::remove(path);
+}
+BENCHMARK(BM_SendNextOctetMap);
+
+void BM_SendNextNetascii(benchmark::State &state)
+{
+  const auto payload = make_payload(64 * messages::DATALEN, 64);
+  const auto path = create_bench_file(payload);
+
+  auto err = std::error_code();
+  auto session = session_t();
+  session.state.mode = messages::NETASCII;
+  session.state.file = filesystem::open_read(path, err);
+
+  for (auto _ : state)
+  {
+    if (!session.state.read_pending())
+    {
+      session.state.file->clear();
+      session.state.file->seekg(0);
+      session.state.block_num = 0;
+      session.state.buffer.clear();
+    }
+    benchmark::DoNotOptimize(send_next(&session));
+  }
+
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations()) *
+                          static_cast<std::int64_t>(messages::DATALEN));
+  session.state.file->close();
+  std::filesystem::remove(path);
+}
+BENCHMARK(BM_SendNextNetascii);
+
+// =============================================================================
+// errors::msg microbenchmark
+// =============================================================================
+void BM_ErrorsMsg(benchmark::State &state)
+{
+  for (auto _ : state)
+  {
+    auto buf = errors::msg(messages::FILE_NOT_FOUND, "File not found.");
+    benchmark::DoNotOptimize(buf);
+  }
+}
+BENCHMARK(BM_ErrorsMsg);
+
+// =============================================================================
+// put_file_t::connect session-setup microbenchmark
+// =============================================================================
+
+/** @brief A receiver that discards every completion. */
+struct null_receiver {
+  using receiver_concept = stdexec::receiver_t;
+  auto set_value(client::client_sender::status_t) && noexcept -> void {}
+  auto set_error(std::error_code) && noexcept -> void {}
+  auto set_stopped() && noexcept -> void {}
+};
+
+void BM_PutFileConnect(benchmark::State &state)
+{
+  const auto payload = make_payload(messages::DATALEN);
+  const auto path = create_bench_file(payload);
+
+  auto manager = client_manager();
+  auto client = manager.make_client();
+  io::socket::socket_address<sockaddr_in6> server_addr;
+
+  for (auto _ : state)
+  {
+    auto sender = client.put(server_addr, path, "bench.bin", messages::OCTET);
+    auto op = sender.connect(null_receiver{});
+    benchmark::DoNotOptimize(&op);
+  }
+
+  std::filesystem::remove(path);
+}
+BENCHMARK(BM_PutFileConnect);
+
+// =============================================================================
+// Loopback throughput harness
+// =============================================================================
+
+/**
+ * @brief A minimal in-process TFTP responder.
+ * @details Serves a fixed payload for every RRQ and swallows every WRQ,
+ * one lock-step transfer at a time on a loopback UDP socket. The
+ * responder runs on its own thread so client_t::get/put drive complete
+ * round trips through the real sender machinery. Its outbound link can
+ * be impaired with configurable loss, duplication and delay so the
+ * retransmission machinery is exercised without leaving the process.
+ */
+class loopback_responder {
+public:
+  /** @brief Outbound link impairments, applied to every datagram. */
+  struct impairments_t {
+    /** @brief The drop probability in parts per million. */
+    std::uint32_t loss_ppm = 0;
+    /** @brief The duplication probability in parts per million. */
+    std::uint32_t duplicate_ppm = 0;
+    /** @brief The added one-way latency, jittered to 50-150%. */
+    std::chrono::microseconds delay{0};
+  };
+
+  static auto instance() -> loopback_responder &
+  {
+    static auto responder = loopback_responder();
+    return responder;
+  }
+
+  [[nodiscard]] auto port() const noexcept -> std::uint16_t { return port_; }
+
+  [[nodiscard]] auto payload() const noexcept -> const std::vector<char> &
+  {
+    return payload_;
+  }
+
+  /**
+   * @brief Applies link impairments to subsequent transfers.
+   * @details An impaired link also shortens the responder's lock-step
+   * receive timeout so dropped datagrams are repaired by its retry
+   * loops well inside the client's retransmission deadline.
+   * @param imp The impairments to apply; the default clears them.
+   */
+  auto set_impairments(impairments_t imp = {}) noexcept -> void
+  {
+    loss_ppm_ = imp.loss_ppm;
+    duplicate_ppm_ = imp.duplicate_ppm;
+    delay_us_ = imp.delay.count();
+
+    const auto impaired =
+        imp.loss_ppm || imp.duplicate_ppm || imp.delay.count();
+    auto timeout = impaired ? timeval{.tv_sec = 0, .tv_usec = 5000}
+                            : timeval{.tv_sec = 2, .tv_usec = 0};
+    ::setsockopt(fd_, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+  }
+
+private:
+  loopback_responder() : payload_(make_payload(1UL << 20))
+  {
+    fd_ = ::socket(AF_INET, SOCK_DGRAM, 0);
+
+    auto timeout = timeval{.tv_sec = 2, .tv_usec = 0};
+    ::setsockopt(fd_, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    ::bind(fd_, reinterpret_cast<sockaddr *>(&addr), sizeof(addr));
+
+    socklen_t len = sizeof(addr);
+    ::getsockname(fd_, reinterpret_cast<sockaddr *>(&addr), &len);
+    port_ = ntohs(addr.sin_port);
+
+    thread_ = std::thread([this] { run(); });
+    thread_.detach();
+  }
+
+  auto run() -> void
+  {
+    auto buf = std::array<char, messages::DATAMSG_MAXLEN>();
+    for (;;)
+    {
+      sockaddr_in6 peer{};
+      socklen_t peer_len = sizeof(peer);
+      auto len = ::recvfrom(fd_, buf.data(), buf.size(), 0,
+                            reinterpret_cast<sockaddr *>(&peer), &peer_len);
+      if (len < static_cast<ssize_t>(sizeof(std::uint16_t)))
+        continue;
+
+      std::uint16_t opc = 0;
+      std::memcpy(&opc, buf.data(), sizeof(opc));
+      switch (ntohs(opc))
+      {
+        case messages::RRQ:
+          serve_get(peer, peer_len);
+          break;
+        case messages::WRQ:
+          serve_put(peer, peer_len);
+          break;
+        default:
+          break;
+      }
+    }
+  }
+
+  auto serve_get(const sockaddr_in6 &peer, socklen_t peer_len) -> void
+  {
+    auto frame = std::vector<char>();
+    std::uint16_t block = 0;
+    std::size_t offset = 0;
+    auto ack = std::array<char, messages::DATAMSG_MAXLEN>();
+
+    for (;;)
+    {
+      auto take = std::min(messages::DATALEN, payload_.size() - offset);
+
+      ++block;
+      frame.resize(sizeof(messages::data));
+      auto *data = reinterpret_cast<messages::data *>(frame.data());
+      data->opc = htons(messages::DATA);
+      data->block_num = htons(block);
+      frame.insert(frame.end(), payload_.data() + offset,
+                   payload_.data() + offset + take);
+      offset += take;
+
+      // Lock-step: resend the block until its ack arrives.
+      auto acked = false;
+      for (int retries = 0; retries < 5 && !acked; ++retries)
+      {
+        send(frame.data(), frame.size(), peer, peer_len);
+
+        auto len = ::recvfrom(fd_, ack.data(), ack.size(), 0, nullptr, nullptr);
+        if (len < static_cast<ssize_t>(sizeof(messages::ack)))
+          continue; // Quiet link: resend the block.
+
+        const auto *msg = reinterpret_cast<messages::ack *>(ack.data());
+        acked = ntohs(msg->opc) == messages::ACK &&
+                ntohs(msg->block_num) == block;
+      }
+      if (!acked)
+        return; // Abandon the transfer.
+
+      if (take < messages::DATALEN)
+        return; // The short (or empty) final block ends the transfer.
+    }
+  }
+
+  auto serve_put(const sockaddr_in6 &peer, socklen_t peer_len) -> void
+  {
+    auto buf = std::array<char, messages::DATAMSG_MAXLEN>();
+    auto ack = messages::ack{.opc = htons(messages::ACK), .block_num = 0};
+
+    for (;;)
+    {
+      // Lock-step: re-ack a quiet link so a dropped datagram in either
+      // direction is repaired instead of abandoning the transfer.
+      auto len = ssize_t{-1};
+      for (int retries = 0;
+           retries < 5 && len < static_cast<ssize_t>(sizeof(messages::data));
+           ++retries)
+      {
+        send(&ack, sizeof(ack), peer, peer_len);
+        len = ::recvfrom(fd_, buf.data(), buf.size(), 0, nullptr, nullptr);
+      }
+      if (len < static_cast<ssize_t>(sizeof(messages::data)))
+        return; // Abandon the transfer.
+
+      const auto *data = reinterpret_cast<messages::data *>(buf.data());
+      if (ntohs(data->opc) != messages::DATA)
+        continue;
+
+      ack.block_num = data->block_num;
+      if (len - sizeof(messages::data) < messages::DATALEN)
+      {
+        // Ack the short final block and end the transfer.
+        send(&ack, sizeof(ack), peer, peer_len);
+        return;
+      }
+    }
+  }
+
+  /**
+   * @brief Sends a datagram through the impaired link.
+   * @details A fixed-seed generator drives loss, duplication and delay
+   * jitter, so a run's impairment sequence is reproducible.
+   */
+  auto send(const void *data, std::size_t len, const sockaddr_in6 &peer,
+            socklen_t peer_len) -> void
+  {
+    constexpr auto PPM = 1'000'000U;
+
+    if (auto delay_us = delay_us_.load(std::memory_order_relaxed))
+    {
+      // Jitter the delay to 50-150% so RTT samples vary like a real
+      // link's and exercise the RTTVAR term of the estimator.
+      const auto percent = 50 + roll() % 101;
+      std::this_thread::sleep_for(
+          std::chrono::microseconds(delay_us * percent / 100));
+    }
+
+    if (roll() % PPM < loss_ppm_.load(std::memory_order_relaxed))
+      return; // Dropped.
+
+    ::sendto(fd_, data, len, 0, reinterpret_cast<const sockaddr *>(&peer),
+             peer_len);
+
+    if (roll() % PPM < duplicate_ppm_.load(std::memory_order_relaxed))
+      ::sendto(fd_, data, len, 0, reinterpret_cast<const sockaddr *>(&peer),
+               peer_len);
+  }
+
+  /** @brief Advances the xorshift impairment generator. */
+  auto roll() noexcept -> std::uint32_t
+  {
+    rng_ ^= rng_ << 13U;
+    rng_ ^= rng_ >> 17U;
+    rng_ ^= rng_ << 5U;
+    return rng_;
+  }
+
+  std::vector<char> payload_;
+  std::thread thread_;
+  int fd_ = -1;
+  std::uint16_t port_ = 0;
+  std::atomic<std::uint32_t> loss_ppm_{0};
+  std::atomic<std::uint32_t> duplicate_ppm_{0};
+  std::atomic<std::int64_t> delay_us_{0};
+  std::uint32_t rng_ = 0x9e3779b9U; // Only touched by the responder thread.
+};
+
+auto responder_address(std::uint16_t port)
+    -> io::socket::socket_address<sockaddr_in6>
+{
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  return io::socket::socket_address<sockaddr_in>(
+      reinterpret_cast<sockaddr *>(&addr), sizeof(addr));
+}
+
+void BM_LoopbackGet(benchmark::State &state)
+{
+  auto &responder = loopback_responder::instance();
+  auto server_addr = responder_address(responder.port());
+
+  auto manager = client_manager();
+  auto client = manager.make_client();
+  const auto local = filesystem::tmpname();
+
+  for (auto _ : state)
+  {
+    auto [status] = stdexec::sync_wait(client.get(server_addr, "bench.bin",
+                                                  local, messages::OCTET))
+                        .value();
+    if (status.first != 0)
+    {
+      state.SkipWithError(status.second.c_str());
+      break;
+    }
+  }
+
+  const auto size = responder.payload().size();
+  const auto packets = size / messages::DATALEN + 1;
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations()) *
+                          static_cast<std::int64_t>(size));
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) *
+                          static_cast<std::int64_t>(packets));
+  std::filesystem::remove(local);
+}
+BENCHMARK(BM_LoopbackGet)->Unit(benchmark::kMillisecond);
+
+void BM_LoopbackPut(benchmark::State &state)
+{
+  auto &responder = loopback_responder::instance();
+  auto server_addr = responder_address(responder.port());
+
+  auto manager = client_manager();
+  auto client = manager.make_client();
+  const auto payload = make_payload(1UL << 20);
+  const auto local = create_bench_file(payload);
+
+  for (auto _ : state)
+  {
+    auto [status] = stdexec::sync_wait(client.put(server_addr, local,
+                                                  "bench.bin",
+                                                  messages::OCTET))
+                        .value();
+    if (status.first != 0)
+    {
+      state.SkipWithError(status.second.c_str());
+      break;
+    }
+  }
+
+  const auto packets = payload.size() / messages::DATALEN + 1;
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations()) *
+                          static_cast<std::int64_t>(payload.size()));
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) *
+                          static_cast<std::int64_t>(packets));
+  std::filesystem::remove(local);
+}
+BENCHMARK(BM_LoopbackPut)->Unit(benchmark::kMillisecond);
+
+// =============================================================================
+// Impaired-link regression benchmarks
+// =============================================================================
+// The responder drops the configured fraction of its datagrams (the
+// benchmark argument, in parts per million), duplicates 0.1% of them
+// and delays each by ~2ms, so achieved goodput and the per-transfer
+// retransmit/timeout/duplicate-ack counters track how the recovery
+// machinery degrades under loss.
+
+void BM_LoopbackGetImpaired(benchmark::State &state)
+{
+  auto &responder = loopback_responder::instance();
+  auto server_addr = responder_address(responder.port());
+  responder.set_impairments(
+      {.loss_ppm = static_cast<std::uint32_t>(state.range(0)),
+       .duplicate_ppm = 1000,
+       .delay = std::chrono::microseconds(2000)});
+
+  auto manager = client_manager();
+  auto timeouts = std::atomic<std::uint64_t>{0};
+  manager.set_metrics_sink(
+      [&](const session_t::state_t::statistics_t &stats) noexcept {
+        timeouts += stats.timeouts;
+      });
+  auto client = manager.make_client();
+  const auto local = filesystem::tmpname();
+
+  for (auto _ : state)
+  {
+    auto [status] = stdexec::sync_wait(client.get(server_addr, "bench.bin",
+                                                  local, messages::OCTET))
+                        .value();
+    if (status.first != 0)
+    {
+      state.SkipWithError(status.second.c_str());
+      break;
+    }
+  }
+
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations()) *
+                          static_cast<std::int64_t>(
+                              responder.payload().size()));
+  state.counters["timeouts"] = benchmark::Counter(
+      static_cast<double>(timeouts), benchmark::Counter::kAvgIterations);
+  responder.set_impairments();
+  std::filesystem::remove(local);
+}
+BENCHMARK(BM_LoopbackGetImpaired)
+    ->Arg(10000)
+    ->Arg(30000)
+    ->Unit(benchmark::kMillisecond);
+
+void BM_LoopbackPutImpaired(benchmark::State &state)
+{
+  auto &responder = loopback_responder::instance();
+  auto server_addr = responder_address(responder.port());
+  responder.set_impairments(
+      {.loss_ppm = static_cast<std::uint32_t>(state.range(0)),
+       .duplicate_ppm = 1000,
+       .delay = std::chrono::microseconds(2000)});
+
+  auto manager = client_manager();
+  auto retransmits = std::atomic<std::uint64_t>{0};
+  auto duplicate_acks = std::atomic<std::uint64_t>{0};
+  auto timeouts = std::atomic<std::uint64_t>{0};
+  manager.set_metrics_sink(
+      [&](const session_t::state_t::statistics_t &stats) noexcept {
+        retransmits += stats.retransmits;
+        duplicate_acks += stats.duplicate_acks;
+        timeouts += stats.timeouts;
+      });
+  auto client = manager.make_client();
+  const auto payload = make_payload(1UL << 20);
+  const auto local = create_bench_file(payload);
+
+  for (auto _ : state)
+  {
+    auto [status] = stdexec::sync_wait(client.put(server_addr, local,
+                                                  "bench.bin",
+                                                  messages::OCTET))
+                        .value();
+    if (status.first != 0)
+    {
+      state.SkipWithError(status.second.c_str());
+      break;
+    }
+  }
+
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations()) *
+                          static_cast<std::int64_t>(payload.size()));
+  state.counters["retransmits"] = benchmark::Counter(
+      static_cast<double>(retransmits), benchmark::Counter::kAvgIterations);
+  state.counters["dup_acks"] = benchmark::Counter(
+      static_cast<double>(duplicate_acks), benchmark::Counter::kAvgIterations);
+  state.counters["timeouts"] = benchmark::Counter(
+      static_cast<double>(timeouts), benchmark::Counter::kAvgIterations);
+  responder.set_impairments();
+  std::filesystem::remove(local);
+}
+BENCHMARK(BM_LoopbackPutImpaired)
+    ->Arg(10000)
+    ->Arg(30000)
+    ->Unit(benchmark::kMillisecond);
+
+} // namespace
+// NOLINTEND
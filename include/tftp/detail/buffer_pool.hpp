@@ -0,0 +1,105 @@
+/* Copyright (C) 2025 Kevin Exton (kevin.exton@pm.me)
+ *
+ * tftp is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tftp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tftp.  If not, see <https://www.gnu.org/licenses/>.
+ */
+/**
+ * @file buffer_pool.hpp
+ * @brief This file defines a pooled buffer arena.
+ */
+#pragma once
+#ifndef TFTP_BUFFER_POOL_HPP
+#define TFTP_BUFFER_POOL_HPP
+#include <mutex>
+#include <vector>
+/** @brief For internal tftp server implementation details. */
+namespace tftp::detail {
+/**
+ * @brief A recycling arena for message buffers.
+ * @details Transfers acquire their session and receive buffers from
+ * the pool and return them on cleanup, so steady-state batch workloads
+ * reuse the same allocations instead of hitting the allocator once per
+ * transfer. Returned buffers keep their grown capacity; the free list
+ * is bounded so an occasional burst does not hoard memory forever. The
+ * pool is mutex-guarded as one pool is shared by every context thread.
+ */
+class buffer_pool {
+public:
+  /** @brief The maximum number of buffers kept on the free list. */
+  static constexpr std::size_t MAX_POOLED = 64;
+
+  /** @brief Constructs a buffer pool.
+   * @details The free list is reserved up front so release() never
+   * allocates. */
+  buffer_pool() { free_.reserve(MAX_POOLED); }
+
+  /**
+   * @brief Acquires a buffer from the pool.
+   * @details The returned buffer is empty with at least the requested
+   * capacity reserved. When the free list is empty a fresh buffer is
+   * allocated.
+   * @param capacity The minimum capacity to reserve.
+   * @returns An empty buffer with at least `capacity` reserved.
+   */
+  auto acquire(std::size_t capacity) -> std::vector<char>
+  {
+    auto buffer = std::vector<char>();
+    {
+      const auto lock = std::lock_guard(mutex_);
+      if (!free_.empty())
+      {
+        buffer = std::move(free_.back());
+        free_.pop_back();
+      }
+    }
+
+    buffer.clear();
+    buffer.reserve(capacity);
+    return buffer;
+  }
+
+  /**
+   * @brief Returns a buffer to the pool.
+   * @details The buffer's storage is recycled for a later acquire();
+   * buffers beyond the free-list bound are simply freed.
+   * @param buffer The buffer to recycle.
+   */
+  auto release(std::vector<char> buffer) noexcept -> void
+  {
+    if (buffer.capacity() == 0)
+      return;
+
+    buffer.clear();
+    const auto lock = std::lock_guard(mutex_);
+    if (free_.size() < MAX_POOLED)
+      free_.push_back(std::move(buffer));
+  }
+
+  /**
+   * @brief The number of buffers on the free list.
+   * @returns The free-list size.
+   */
+  [[nodiscard]] auto size() const noexcept -> std::size_t
+  {
+    const auto lock = std::lock_guard(mutex_);
+    return free_.size();
+  }
+
+private:
+  /** @brief Guards the free list; the pool is shared across contexts. */
+  mutable std::mutex mutex_;
+  /** @brief Recycled buffers, most recently released last. */
+  std::vector<std::vector<char>> free_;
+};
+} // namespace tftp::detail
+#endif // TFTP_BUFFER_POOL_HPP
@@ -20,9 +20,15 @@
 #pragma once
 #ifndef TFTP_DNS_HPP
 #define TFTP_DNS_HPP
+#include <chrono>
+#include <mutex>
+#include <optional>
+#include <string>
 #include <system_error>
+#include <unordered_map>
 
 #include <netdb.h>
+#include <netinet/in.h>
 /** @brief Defines internal dns implementation details. */
 namespace tftp::dns {
 /** @brief dns error conditions. */
@@ -81,6 +87,68 @@ inline auto dns_category() -> const std::error_category &;
  */
 inline auto make_error_code(errc err) -> std::error_code;
 
+/**
+ * @brief A TTL-aware cache of resolved addresses.
+ * @details getaddrinfo does not expose record TTLs, so entries are held
+ * for a fixed DEFAULT_TTL and evicted lazily as lookups find them
+ * expired. Keys are "hostname:port" strings, so the same host resolved
+ * for different services is cached independently.
+ */
+class address_cache {
+public:
+  /** @brief The expiry clock. */
+  using clock = std::chrono::steady_clock;
+  /** @brief The entry time to live type. */
+  using duration = std::chrono::seconds;
+
+  /** @brief The time to live assigned to inserted entries. */
+  static constexpr auto DEFAULT_TTL = duration(60);
+
+  /** @brief A cached socket address and its length. */
+  struct address_t {
+    /** @brief The resolved address bytes. */
+    sockaddr_in6 storage;
+    /** @brief The resolved address length. */
+    socklen_t length;
+  };
+
+  /**
+   * @brief The process-wide cache.
+   * @returns A reference to the address_cache singleton.
+   */
+  static inline auto instance() -> address_cache &;
+
+  /**
+   * @brief Looks up a cached address.
+   * @param key The "hostname:port" cache key.
+   * @returns The cached address, or std::nullopt on a miss.
+   */
+  [[nodiscard]] inline auto
+  lookup(const std::string &key) -> std::optional<address_t>;
+
+  /**
+   * @brief Inserts or refreshes a cached address.
+   * @param key The "hostname:port" cache key.
+   * @param address The resolved address.
+   * @param length The resolved address length.
+   * @param ttl The entry time to live.
+   */
+  inline auto insert(const std::string &key, const sockaddr *address,
+                     socklen_t length, duration ttl = DEFAULT_TTL) -> void;
+
+  /** @brief Drops every cached entry. */
+  inline auto clear() -> void;
+
+private:
+  /** @brief A cached address and its expiry. */
+  struct entry_t {
+    address_t address;
+    clock::time_point expiry;
+  };
+
+  std::mutex mutex_;
+  std::unordered_map<std::string, entry_t> entries_;
+};
 } // namespace tftp::dns
 
 #include "impl/dns_impl.hpp" // IWYU pragma: export
@@ -21,6 +21,9 @@
 #ifndef TFTP_DNS_IMPL_HPP
 #define TFTP_DNS_IMPL_HPP
 #include "tftp/detail/dns.hpp"
+
+#include <algorithm>
+#include <cstring>
 namespace tftp::dns {
 [[nodiscard]] inline auto dns_category_impl::name() const noexcept -> const
     char *
@@ -85,6 +88,47 @@ inline auto make_error_code(errc err) -> std::error_code
   return {static_cast<int>(err), dns_category()};
 }
 
+inline auto address_cache::instance() -> address_cache &
+{
+  static address_cache cache;
+  return cache;
+}
+
+[[nodiscard]] inline auto
+address_cache::lookup(const std::string &key) -> std::optional<address_t>
+{
+  const std::lock_guard lock{mutex_};
+  auto found = entries_.find(key);
+  if (found == entries_.end())
+    return std::nullopt;
+
+  if (found->second.expiry <= clock::now())
+  {
+    entries_.erase(found);
+    return std::nullopt;
+  }
+
+  return found->second.address;
+}
+
+inline auto address_cache::insert(const std::string &key,
+                                  const sockaddr *address, socklen_t length,
+                                  duration ttl) -> void
+{
+  address_t cached{};
+  cached.length = std::min<socklen_t>(length, sizeof(cached.storage));
+  std::memcpy(&cached.storage, address, cached.length);
+
+  const std::lock_guard lock{mutex_};
+  entries_.insert_or_assign(key, entry_t{cached, clock::now() + ttl});
+}
+
+inline auto address_cache::clear() -> void
+{
+  const std::lock_guard lock{mutex_};
+  entries_.clear();
+}
+
 } // namespace tftp::dns
 
 namespace std {
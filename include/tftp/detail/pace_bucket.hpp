@@ -0,0 +1,181 @@
+/* Copyright (C) 2025 Kevin Exton (kevin.exton@pm.me)
+ *
+ * tftp is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tftp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tftp.  If not, see <https://www.gnu.org/licenses/>.
+ */
+/**
+ * @file pace_bucket.hpp
+ * @brief This file declares a token bucket that paces outbound frames.
+ */
+#pragma once
+#ifndef TFTP_PACE_BUCKET_HPP
+#define TFTP_PACE_BUCKET_HPP
+#include <net/timers/timers.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <utility>
+/** @brief TFTP implementation details. */
+namespace tftp::detail {
+/**
+ * @brief A token bucket that paces outbound frames.
+ * @details Blasting a full window back to back overflows the shallow
+ * buffers on constrained links, so a configured ceiling rate accrues a
+ * byte budget that each departing frame must cover. The budget is
+ * capped near one tick's worth of bytes, which spreads a window across
+ * the round trip instead of banking an idle transfer's credit into a
+ * burst. Like the retry deadline, a blocked bucket rides a periodic
+ * tick registered once per transfer: re-driving the drain is a flag
+ * check, not timer-queue traffic.
+ */
+class pace_bucket {
+public:
+  /** @brief The budget clock. */
+  using clock = std::chrono::steady_clock;
+  /** @brief The budget timestamp. */
+  using timestamp = clock::time_point;
+  /** @brief The tick duration. */
+  using duration = std::chrono::milliseconds;
+  /** @brief The underlying timer handle. */
+  using timer_id = net::timers::timer_id;
+
+  /** @brief The drain re-drive granularity. */
+  static constexpr auto TICK = duration(2);
+  /** @brief The invalid timer value. */
+  static constexpr auto INVALID_TIMER = net::timers::INVALID_TIMER;
+
+  pace_bucket() = default;
+
+  /**
+   * @brief Constructs a bucket with a ceiling rate.
+   * @param rate The ceiling in bytes per second; 0 disables pacing.
+   */
+  explicit pace_bucket(std::uint64_t rate) noexcept
+      : credit_(budget(rate)), rate_(rate)
+  {
+  }
+
+  /**
+   * @brief Tries to cover a frame with the accrued byte budget.
+   * @details The budget refills continuously at the ceiling rate and
+   * is capped at the frame plus one tick's worth of bytes.
+   * @param size The frame size in octets.
+   * @returns `true` if the frame may leave now, `false` once the
+   * budget is exhausted; the armed tick then re-drives the drain.
+   */
+  auto admit(std::uint64_t size) noexcept -> bool
+  {
+    if (rate_ == 0)
+      return true;
+
+    // Credit is held in byte-nanoseconds so slow refills are not
+    // truncated away; the elapsed clamp bounds the refill product.
+    const auto now = clock::now();
+    const auto elapsed = std::min<std::chrono::nanoseconds>(
+        now - last_, std::chrono::milliseconds(100));
+    last_ = now;
+
+    const auto need = size * NS_PER_S;
+    credit_ = std::min(
+        credit_ + rate_ * static_cast<std::uint64_t>(elapsed.count()),
+        need + budget(rate_));
+
+    if (credit_ < need)
+    {
+      blocked_ = true;
+      return false;
+    }
+
+    credit_ -= need;
+    blocked_ = false;
+    return true;
+  }
+
+  /**
+   * @brief Arms the drain re-drive tick.
+   * @details The first call registers the periodic tick with the timer
+   * queue and retains the callback; later calls are no-ops. The
+   * callback is invoked once per tick while the bucket is blocked.
+   * @param timers The context's timer queue.
+   * @param callback The drain callback.
+   */
+  template <typename Timers, typename Callback>
+  auto arm(Timers &timers, Callback &&callback) -> void
+  {
+    if (registered_)
+      return;
+
+    registered_ = true;
+    timer_ = timers.add(
+        TICK,
+        [this,
+         callback = std::forward<Callback>(callback)](auto) mutable noexcept {
+          if (!blocked_)
+            return;
+
+          blocked_ = false;
+          callback();
+        },
+        TICK);
+  }
+
+  /**
+   * @brief Cancels the tick and releases the underlying timer.
+   * @param timers The context's timer queue.
+   */
+  template <typename Timers> auto cancel(Timers &timers) noexcept -> void
+  {
+    blocked_ = false;
+    registered_ = false;
+    timer_ = timers.remove(timer_);
+  }
+
+  /**
+   * @brief The configured ceiling rate.
+   * @returns The ceiling in bytes per second; 0 when pacing is off.
+   */
+  [[nodiscard]] auto rate() const noexcept -> std::uint64_t { return rate_; }
+
+  /**
+   * @brief Whether the budget is exhausted.
+   * @returns `true` while a frame is waiting on the budget.
+   */
+  [[nodiscard]] auto blocked() const noexcept -> bool { return blocked_; }
+
+private:
+  /** @brief Nanoseconds per second. */
+  static constexpr auto NS_PER_S = std::uint64_t{1'000'000'000};
+
+  /**
+   * @brief One tick's worth of credit at a ceiling rate.
+   * @param rate The ceiling in bytes per second.
+   * @returns The credit in byte-nanoseconds.
+   */
+  static constexpr auto budget(std::uint64_t rate) noexcept -> std::uint64_t
+  {
+    return rate * static_cast<std::uint64_t>(
+                      std::chrono::duration_cast<std::chrono::nanoseconds>(
+                          TICK)
+                          .count());
+  }
+
+  timestamp last_{clock::now()};
+  std::uint64_t credit_ = 0;
+  std::uint64_t rate_ = 0;
+  timer_id timer_{INVALID_TIMER};
+  bool blocked_ = false;
+  bool registered_ = false;
+};
+} // namespace tftp::detail
+#endif // TFTP_PACE_BUCKET_HPP
@@ -0,0 +1,130 @@
+/* Copyright (C) 2025 Kevin Exton (kevin.exton@pm.me)
+ *
+ * tftp is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tftp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tftp.  If not, see <https://www.gnu.org/licenses/>.
+ */
+/**
+ * @file retry_timer.hpp
+ * @brief This file declares a lazily rescheduled retry deadline.
+ */
+#pragma once
+#ifndef TFTP_RETRY_TIMER_HPP
+#define TFTP_RETRY_TIMER_HPP
+#include <net/timers/timers.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <utility>
+/** @brief TFTP implementation details. */
+namespace tftp::detail {
+/**
+ * @brief A lazily rescheduled retry deadline.
+ * @details Removing and re-adding a timer-queue entry on every
+ * acknowledgement interrupts the context's event loop, which becomes a
+ * measurable tax at thousands of blocks per second. Instead, the
+ * underlying timer is registered once per transfer as a fine-grained
+ * periodic tick, and rescheduling just moves a deadline forward: an
+ * O(1) store with no timer-queue traffic. Ticks that arrive before the
+ * deadline are deferred. This is the single-slot equivalent of a
+ * timing wheel: each transfer only ever has one outstanding retry
+ * deadline, so one deadline riding a shared tick replaces a bucketed
+ * hierarchy.
+ */
+class retry_timer {
+public:
+  /** @brief The deadline clock. */
+  using clock = std::chrono::steady_clock;
+  /** @brief The deadline timestamp. */
+  using timestamp = clock::time_point;
+  /** @brief The deadline duration. */
+  using duration = std::chrono::milliseconds;
+  /** @brief The underlying timer handle. */
+  using timer_id = net::timers::timer_id;
+
+  /** @brief The deadline check granularity. */
+  static constexpr auto TICK = duration(2);
+  /** @brief The invalid timer value. */
+  static constexpr auto INVALID_TIMER = net::timers::INVALID_TIMER;
+
+  /**
+   * @brief Arms the retry deadline.
+   * @details The first call registers the periodic tick with the timer
+   * queue and retains the callback; later calls are equivalent to
+   * reschedule(). The callback is invoked with the number of
+   * consecutive expiries since the deadline last moved.
+   * @param timers The context's timer queue.
+   * @param delay The time until the deadline expires.
+   * @param callback The expiry callback.
+   */
+  template <typename Timers, typename Callback>
+  auto arm(Timers &timers, duration delay, Callback &&callback) -> void
+  {
+    reschedule(delay);
+    if (registered_)
+      return;
+
+    registered_ = true;
+    timer_ = timers.add(
+        TICK,
+        [this,
+         callback = std::forward<Callback>(callback)](auto) mutable noexcept {
+          if (!armed_ || clock::now() < deadline_)
+            return;
+
+          deadline_ = clock::now() + delay_;
+          callback(++expiries_);
+        },
+        TICK);
+  }
+
+  /**
+   * @brief Moves the deadline.
+   * @details An O(1) store: the armed tick picks the new deadline up
+   * without any timer-queue traffic.
+   * @param delay The time until the deadline expires.
+   */
+  auto reschedule(duration delay) noexcept -> void
+  {
+    delay_ = delay;
+    deadline_ = clock::now() + delay;
+    expiries_ = 0;
+    armed_ = true;
+  }
+
+  /**
+   * @brief Cancels the deadline and releases the underlying timer.
+   * @param timers The context's timer queue.
+   */
+  template <typename Timers> auto cancel(Timers &timers) noexcept -> void
+  {
+    armed_ = false;
+    registered_ = false;
+    timer_ = timers.remove(timer_);
+  }
+
+  /**
+   * @brief Whether the deadline is armed.
+   * @returns `true` while an expiry is pending.
+   */
+  [[nodiscard]] auto armed() const noexcept -> bool { return armed_; }
+
+private:
+  timestamp deadline_{};
+  duration delay_{TICK};
+  timer_id timer_{INVALID_TIMER};
+  std::uint32_t expiries_ = 0;
+  bool armed_ = false;
+  bool registered_ = false;
+};
+} // namespace tftp::detail
+#endif // TFTP_RETRY_TIMER_HPP
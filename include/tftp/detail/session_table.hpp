@@ -0,0 +1,287 @@
+/* Copyright (C) 2025 Kevin Exton (kevin.exton@pm.me)
+ *
+ * tftp is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tftp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tftp.  If not, see <https://www.gnu.org/licenses/>.
+ */
+/**
+ * @file session_table.hpp
+ * @brief This file defines a flat hash table of TFTP sessions.
+ */
+#pragma once
+#ifndef TFTP_SESSION_TABLE_HPP
+#define TFTP_SESSION_TABLE_HPP
+#include "tftp/protocol/tftp_session.hpp"
+
+#include <cstdint>
+#include <iterator>
+#include <utility>
+#include <vector>
+/** @brief For internal tftp server implementation details. */
+namespace tftp::detail {
+/**
+ * @brief An open-addressing hash table of TFTP sessions.
+ * @details Sessions are stored inline in a contiguous slot array and
+ * located by linear probing on a 64-bit hash of the peer's address and
+ * port, so the per-packet session lookup touches one cache line run
+ * instead of chasing tree nodes. Duplicate keys are permitted, keeping
+ * the multimap semantics the callers were written against. Iterators
+ * are invalidated when an insertion grows the table.
+ */
+class session_table {
+public:
+  /** @brief The session key type. */
+  using key_type = io::socket::socket_address<sockaddr_in6>;
+  /** @brief The session value type. */
+  using mapped_type = session_t;
+  /** @brief The slot value type. */
+  using value_type = std::pair<key_type, mapped_type>;
+
+  /** @brief The number of slots in an empty table. */
+  static constexpr std::size_t INITIAL_SLOTS = 16;
+
+  /** @brief A forward iterator over the occupied slots. */
+  class iterator {
+  public:
+    /** @brief The iterator category. */
+    using iterator_category = std::forward_iterator_tag;
+    /** @brief The iterator value type. */
+    using value_type = session_table::value_type;
+    /** @brief The iterator difference type. */
+    using difference_type = std::ptrdiff_t;
+
+    /** @brief Constructs a singular iterator. */
+    iterator() = default;
+
+    /** @brief Dereferences the iterator.
+     * @returns A reference to the slot's key/session pair. */
+    auto operator*() const noexcept -> value_type &
+    {
+      return table_->slots_[index_].value;
+    }
+
+    /** @brief Member access to the slot's key/session pair.
+     * @returns A pointer to the slot's key/session pair. */
+    auto operator->() const noexcept -> value_type *
+    {
+      return std::addressof(table_->slots_[index_].value);
+    }
+
+    /** @brief Advances to the next occupied slot.
+     * @returns A reference to this iterator. */
+    auto operator++() noexcept -> iterator &
+    {
+      ++index_;
+      skip_unoccupied();
+      return *this;
+    }
+
+    /** @brief Advances to the next occupied slot.
+     * @returns The iterator prior to the increment. */
+    auto operator++(int) noexcept -> iterator
+    {
+      auto prev = *this;
+      ++*this;
+      return prev;
+    }
+
+    /** @brief Compares two iterators for equality. */
+    friend auto operator==(const iterator &, const iterator &) -> bool =
+        default;
+
+  private:
+    friend class session_table;
+
+    iterator(session_table *table, std::size_t index) noexcept
+        : table_(table), index_(index)
+    {
+      skip_unoccupied();
+    }
+
+    auto skip_unoccupied() noexcept -> void
+    {
+      while (index_ < table_->slots_.size() &&
+             table_->slots_[index_].state != slot_state::OCCUPIED)
+        ++index_;
+    }
+
+    session_table *table_ = nullptr;
+    std::size_t index_ = 0;
+  };
+
+  /** @brief Constructs an empty session table. */
+  session_table() : slots_(INITIAL_SLOTS) {}
+
+  /**
+   * @brief Inserts a session for a peer address.
+   * @details Duplicate keys are always inserted, matching the multimap
+   * this table replaces. Growing the table invalidates iterators.
+   * @param key The peer address to key the session on.
+   * @param session The session to insert.
+   * @returns An iterator to the inserted session.
+   */
+  auto emplace(const key_type &key, mapped_type session) -> iterator
+  {
+    if ((size_ + tombstones_ + 1) * 4 > slots_.size() * 3)
+      rehash(slots_.size() * 2);
+
+    const auto hash = hash_key(key);
+    auto index = hash & (slots_.size() - 1);
+    while (slots_[index].state == slot_state::OCCUPIED)
+      index = (index + 1) & (slots_.size() - 1);
+
+    auto &slot = slots_[index];
+    if (slot.state == slot_state::TOMBSTONE)
+      --tombstones_;
+
+    slot.state = slot_state::OCCUPIED;
+    slot.hash = hash;
+    slot.value = value_type(key, std::move(session));
+    ++size_;
+    return {this, index};
+  }
+
+  /**
+   * @brief Finds the first session keyed on a peer address.
+   * @param key The peer address to look up.
+   * @returns An iterator to the session, or end() if none exists.
+   */
+  auto find(const key_type &key) noexcept -> iterator
+  {
+    const auto hash = hash_key(key);
+    auto index = hash & (slots_.size() - 1);
+    while (slots_[index].state != slot_state::EMPTY)
+    {
+      const auto &slot = slots_[index];
+      if (slot.state == slot_state::OCCUPIED && slot.hash == hash &&
+          key_equal(slot.value.first, key))
+        return {this, index};
+
+      index = (index + 1) & (slots_.size() - 1);
+    }
+
+    return end();
+  }
+
+  /**
+   * @brief Erases a session.
+   * @details The slot is tombstoned so probe chains stay intact;
+   * tombstones are dropped on the next rehash.
+   * @param pos An iterator to the session to erase.
+   * @returns An iterator to the next occupied slot.
+   */
+  auto erase(iterator pos) noexcept -> iterator
+  {
+    auto &slot = slots_[pos.index_];
+    slot.state = slot_state::TOMBSTONE;
+    slot.value = value_type();
+    --size_;
+    ++tombstones_;
+    return {this, pos.index_ + 1};
+  }
+
+  /** @brief Removes every session, keeping the slot array. */
+  auto clear() noexcept -> void
+  {
+    for (auto &slot : slots_)
+      slot = slot_t();
+
+    size_ = 0;
+    tombstones_ = 0;
+  }
+
+  /** @brief The number of stored sessions.
+   * @returns The session count. */
+  [[nodiscard]] auto size() const noexcept -> std::size_t { return size_; }
+
+  /** @brief Whether the table is empty.
+   * @returns `true` if no sessions are stored. */
+  [[nodiscard]] auto empty() const noexcept -> bool { return size_ == 0; }
+
+  /** @brief An iterator to the first session.
+   * @returns The begin iterator. */
+  auto begin() noexcept -> iterator { return {this, 0}; }
+
+  /** @brief The past-the-end iterator.
+   * @returns The end iterator. */
+  auto end() noexcept -> iterator { return {this, slots_.size()}; }
+
+private:
+  /** @brief The occupancy state of a slot. */
+  enum class slot_state : std::uint8_t { EMPTY, OCCUPIED, TOMBSTONE };
+
+  /** @brief A table slot holding a session inline. */
+  struct slot_t {
+    /** @brief The cached hash of the slot's key. */
+    std::uint64_t hash = 0;
+    /** @brief The slot's key/session pair. */
+    value_type value;
+    /** @brief The slot's occupancy state. */
+    slot_state state = slot_state::EMPTY;
+  };
+
+  /**
+   * @brief Hashes a peer address.
+   * @details FNV-1a over the address, port, and family fields.
+   * @param key The peer address to hash.
+   * @returns A 64-bit hash of the address and port.
+   */
+  static auto hash_key(const key_type &key) noexcept -> std::uint64_t
+  {
+    constexpr auto FNV_OFFSET = 0xcbf29ce484222325ULL;
+    constexpr auto FNV_PRIME = 0x100000001b3ULL;
+
+    auto hash = FNV_OFFSET;
+    const auto mix = [&hash](const void *data, std::size_t len) noexcept {
+      const auto *bytes = static_cast<const unsigned char *>(data);
+      for (std::size_t i = 0; i < len; ++i)
+      {
+        hash ^= bytes[i]; // NOLINT(cppcoreguidelines-pro-bounds-*)
+        hash *= FNV_PRIME;
+      }
+    };
+
+    auto addr = key;
+    mix(&addr->sin6_addr, sizeof(addr->sin6_addr));
+    mix(&addr->sin6_port, sizeof(addr->sin6_port));
+    mix(&addr->sin6_family, sizeof(addr->sin6_family));
+    return hash;
+  }
+
+  /** @brief Key equality in terms of the key's ordering. */
+  static auto key_equal(const key_type &lhs, const key_type &rhs) -> bool
+  {
+    return !(lhs < rhs) && !(rhs < lhs);
+  }
+
+  /** @brief Grows the slot array and reinserts the occupied slots. */
+  auto rehash(std::size_t slots) -> void
+  {
+    auto old = std::exchange(slots_, std::vector<slot_t>(slots));
+    size_ = 0;
+    tombstones_ = 0;
+    for (auto &slot : old)
+    {
+      if (slot.state == slot_state::OCCUPIED)
+        emplace(slot.value.first, std::move(slot.value.second));
+    }
+  }
+
+  /** @brief The slot array; its size is always a power of two. */
+  std::vector<slot_t> slots_;
+  /** @brief The number of occupied slots. */
+  std::size_t size_ = 0;
+  /** @brief The number of tombstoned slots. */
+  std::size_t tombstones_ = 0;
+};
+} // namespace tftp::detail
+#endif // TFTP_SESSION_TABLE_HPP
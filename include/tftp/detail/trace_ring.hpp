@@ -0,0 +1,138 @@
+/* Copyright (C) 2025 Kevin Exton (kevin.exton@pm.me)
+ *
+ * tftp is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tftp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tftp.  If not, see <https://www.gnu.org/licenses/>.
+ */
+/**
+ * @file trace_ring.hpp
+ * @brief This file defines a flight recorder for packet hot-path events.
+ */
+#pragma once
+#ifndef TFTP_TRACE_RING_HPP
+#define TFTP_TRACE_RING_HPP
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+namespace tftp::detail {
+/** @brief One compact binary trace event. */
+struct trace_event {
+  /** @brief Nanoseconds since the ring was created. */
+  std::uint64_t time_ns = 0;
+  /** @brief The TFTP opcode observed. */
+  std::uint16_t opc = 0;
+  /** @brief The protocol block number. */
+  std::uint16_t block = 0;
+  /** @brief Event flags (`trace_ring::FLAG_*`). */
+  std::uint8_t flags = 0;
+};
+
+#ifdef TFTP_ENABLE_TRACE
+/**
+ * @brief A fixed-size flight recorder for packet hot-path events.
+ * @details A formatted log line per packet is prohibitive at line rate,
+ * so the handlers record compact binary events into a per-transfer ring
+ * instead and the ring is only formatted out when a transfer fails (or
+ * on demand). Events are written and read on the transfer's context
+ * thread; the sequence counter is a relaxed atomic so a dump racing a
+ * teardown from another thread stays coherent. The ring is compiled
+ * down to an empty stub unless `TFTP_ENABLE_TRACE` is defined (see the
+ * option in `src/CMakeLists.txt`).
+ */
+class trace_ring {
+public:
+  /** @brief The monotonic event clock. */
+  using clock = std::chrono::steady_clock;
+  /** @brief Whether tracing is compiled in. */
+  static constexpr auto enabled = true;
+  /** @brief The number of events the ring retains; a power of two so
+   * the slot index reduces to a mask. */
+  static constexpr auto CAPACITY = 512UL;
+  /** @brief Event flag: the block was queued again after a loss signal. */
+  static constexpr std::uint8_t FLAG_RETRANSMIT = 1U << 0U;
+
+  /**
+   * @brief Records one event, overwriting the oldest when full.
+   * @param opc The TFTP opcode observed.
+   * @param block The protocol block number.
+   * @param flags Event flags (`FLAG_*`).
+   */
+  auto record(std::uint16_t opc, std::uint16_t block,
+              std::uint8_t flags = 0) noexcept -> void
+  {
+    const auto seq = head_.load(std::memory_order_relaxed);
+    auto &event = events_[seq % CAPACITY];
+    event.time_ns = static_cast<std::uint64_t>(
+        std::chrono::nanoseconds(clock::now() - start_).count());
+    event.opc = opc;
+    event.block = block;
+    event.flags = flags;
+    head_.store(seq + 1, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Copies the retained events out, oldest first.
+   * @returns The retained events in recording order.
+   */
+  [[nodiscard]] auto snapshot() const -> std::vector<trace_event>
+  {
+    const auto head = head_.load(std::memory_order_relaxed);
+    const auto count = std::min<std::uint64_t>(head, CAPACITY);
+
+    auto events = std::vector<trace_event>();
+    events.reserve(count);
+    for (auto seq = head - count; seq != head; ++seq)
+      events.push_back(events_[seq % CAPACITY]);
+
+    return events;
+  }
+
+private:
+  /** @brief The event slots. */
+  std::array<trace_event, CAPACITY> events_{};
+  /** @brief The next event sequence number. */
+  std::atomic<std::uint64_t> head_{0};
+  /** @brief The ring creation time; event timestamps are relative. */
+  clock::time_point start_{clock::now()};
+};
+#else
+/**
+ * @brief The disabled flight recorder: every operation compiles away.
+ * @details Stands in for the real ring when `TFTP_ENABLE_TRACE` is not
+ * defined so the call sites need no preprocessor guards.
+ */
+class trace_ring {
+public:
+  /** @brief Whether tracing is compiled in. */
+  static constexpr auto enabled = false;
+  /** @brief Event flag: the block was queued again after a loss signal. */
+  static constexpr std::uint8_t FLAG_RETRANSMIT = 1U << 0U;
+
+  /** @brief Discards the event. */
+  auto record(std::uint16_t /*opc*/, std::uint16_t /*block*/,
+              std::uint8_t /*flags*/ = 0) noexcept -> void
+  {
+  }
+
+  /** @brief There are never any retained events. */
+  [[nodiscard]] auto snapshot() const -> std::vector<trace_event>
+  {
+    return {};
+  }
+};
+#endif // TFTP_ENABLE_TRACE
+} // namespace tftp::detail
+
+#endif // TFTP_TRACE_RING_HPP
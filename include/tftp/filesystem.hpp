@@ -23,8 +23,53 @@
 #include <atomic>
 #include <filesystem>
 #include <fstream>
+#include <memory>
 /** @brief For TFTP filesystem management. */
 namespace tftp::filesystem {
+/**
+ * @brief A read-only memory mapping of a file.
+ * @details Owns an mmap'd region for the lifetime of the object. The
+ * mapping is advised for sequential access, so block reads avoid the
+ * per-read copy and locking of an fstream.
+ */
+class file_map {
+public:
+  /**
+   * @brief Constructs a file map from a mapped region.
+   * @param addr The mapped region. Ownership is transferred.
+   * @param size The size of the mapped region in bytes.
+   */
+  file_map(void *addr, std::size_t size) noexcept : addr_(addr), size_(size) {}
+
+  /** @brief Deleted copy constructor. Mappings are not copyable. */
+  file_map(const file_map &) = delete;
+  /** @brief Deleted copy assignment operator. */
+  auto operator=(const file_map &) -> file_map & = delete;
+
+  /** @brief Destructor. Unmaps the region. */
+  ~file_map();
+
+  /**
+   * @brief The mapped file contents.
+   * @returns A pointer to the beginning of the mapped region.
+   */
+  [[nodiscard]] auto data() const noexcept -> const char *
+  {
+    return static_cast<const char *>(addr_);
+  }
+
+  /**
+   * @brief The size of the mapped file.
+   * @returns The size of the mapped region in bytes.
+   */
+  [[nodiscard]] auto size() const noexcept -> std::size_t { return size_; }
+
+private:
+  /** @brief The mapped region. */
+  void *addr_ = nullptr;
+  /** @brief The size of the mapped region. */
+  std::size_t size_ = 0;
+};
 /** @brief The temporary file prefix used for generating temporary filenames. */
 constexpr auto prefix = "tftp.";
 
@@ -57,6 +102,17 @@ auto mail_directory() noexcept -> const std::filesystem::path &;
  */
 auto tmpname() -> std::filesystem::path;
 
+/**
+ * @brief Generates the next available temporary filename beside a target.
+ * @details Placing the temporary in the target's directory keeps the
+ * final rename on one filesystem: renaming from the system temporary
+ * directory to another filesystem degrades to a full copy.
+ * @param target The file the temporary will eventually be renamed to.
+ * @return Path to a uniquely generated hidden temporary file (not yet
+ * created) in the target's directory.
+ */
+auto tmpname(const std::filesystem::path &target) -> std::filesystem::path;
+
 /**
  * @brief Creates a file or updates its modification time if it exists.
  * @param file Path to the file to touch.
@@ -73,10 +129,23 @@ auto touch(const std::filesystem::path &file) -> std::error_code;
 auto open_read(const std::filesystem::path &file,
                std::error_code &err) -> std::shared_ptr<std::fstream>;
 
+/**
+ * @brief Memory-maps a file for reading.
+ * @details The mapping is advised for sequential access. Empty files
+ * produce an empty map rather than an error.
+ * @param file The file to map.
+ * @param[out] err An error code that is cleared on success and set on error.
+ * @returns A shared pointer to a read-only file mapping.
+ */
+auto open_map(const std::filesystem::path &file,
+              std::error_code &err) -> std::shared_ptr<file_map>;
+
 /**
  * @brief Opens a file for writing.
  * @details Writing a file to disk involves writing data to a
- * temporary file then renaming it to the target destination.
+ * temporary file then renaming it to the target destination. The
+ * temporary is created in the target's directory so the rename never
+ * crosses a filesystem boundary.
  * @param file The file to open.
  * @param[in,out] tmp The path of the temporary file.
  * @param[out] err An error code that is cleared on success and set on error.
@@ -25,10 +25,17 @@
 #include "tftp/tftp.hpp"
 
 #include <spdlog/spdlog.h>
+
+#include <chrono>
+#include <thread>
 /** @brief TFTP client namespace. */
 namespace tftp::client {
 /** @brief Internal client implementation details. */
 namespace detail {
+// Shared utilities from tftp::detail: this namespace shadows it inside
+// the client, so the names are pulled in where they are used.
+using tftp::detail::pace_bucket;
+using tftp::detail::trace_ring;
 /**
  * @brief Validates and extracts message string from a TFTP error message.
  * @param error A pointer to a TFTP error message.
@@ -48,6 +55,32 @@ get_error_message(const messages::error *error,
   return begin;
 }
 
+/**
+ * @brief Appends a null-terminated string to a message buffer.
+ * @param buffer The message buffer to append to.
+ * @param str The string to append.
+ */
+static inline auto append_string(std::vector<char> &buffer,
+                                 std::string_view str) -> void
+{
+  buffer.insert(buffer.end(), str.begin(), str.end());
+  buffer.push_back('\0');
+}
+
+/**
+ * @brief Appends a name/value option pair to a request message (RFC 2347).
+ * @param buffer The message buffer to append to.
+ * @param name The option name.
+ * @param value The option value.
+ */
+static inline auto append_option(std::vector<char> &buffer,
+                                 std::string_view name,
+                                 std::uint64_t value) -> void
+{
+  append_string(buffer, name);
+  append_string(buffer, std::to_string(value));
+}
+
 /**
  * @brief Handles exceptions raised by the `handler` callback.
  * @details try_with attempts to run the handler. If the handler raises
@@ -104,11 +137,146 @@ auto client_sender::client_state<Receiver>::error_handler(
       [&]() noexcept { this->cleanup(); });
 }
 
+template <typename Receiver>
+auto client_sender::client_state<Receiver>::options_fallback() noexcept -> void
+{
+  if (!options_pending)
+    return;
+
+  // The server ignored the request options (RFC 2347), so the
+  // transfer proceeds with the protocol defaults: unicast, in order.
+  session.state.blksize = messages::DATALEN;
+  session.state.windowsize = messages::WINDOWSIZE_MIN;
+  session.state.multicast = false;
+  options_pending = false;
+}
+
+template <typename Receiver>
+auto client_sender::client_state<Receiver>::filter_peer() noexcept -> bool
+{
+  // recvmsg writes the datagram's source over the send destination.
+  const auto &source = sockmsg.address;
+  if (!peer_pinned)
+  {
+    peer = source;
+    peer_pinned = true;
+    return true;
+  }
+
+  if (!(source < peer) && !(peer < source))
+    return true;
+
+  sockmsg.address = peer;
+  return false;
+}
+
+template <typename Receiver>
+auto client_sender::client_state<Receiver>::enqueue_sendmsg(
+    const std::vector<char> &buf) noexcept -> void
+{
+  detail::try_with(
+      std::move(receiver),
+      [&] {
+        auto frame = pool ? pool->acquire(buf.size()) : std::vector<char>();
+        frame.assign(buf.begin(), buf.end());
+        outbox.emplace_back(std::move(frame));
+      },
+      [&]() noexcept { this->cleanup(); });
+}
+
+template <typename Receiver>
+auto client_sender::client_state<Receiver>::flush_sendmsg() noexcept -> void
+{
+  using namespace stdexec;
+  using namespace detail;
+
+  if (sending || outbox.empty())
+    return;
+
+  try_with(
+      std::move(receiver),
+      [&] {
+        // A frame leaves only when the token bucket covers it; the
+        // armed tick re-drives the drain once budget accrues.
+        if (!pace.admit(outbox.front().size()))
+          return pace.arm(ctx->timers,
+                          [this]() noexcept { this->flush_sendmsg(); });
+
+        sending = true;
+        sender auto sendmsg =
+            io::sendmsg(socket,
+                        socket_message{.address = sockmsg.address,
+                                       .buffers = outbox.front()},
+                        0) |
+            then([&](auto) noexcept {
+              // A completion can land after the transfer finalized and
+              // cleanup() recycled the outbox; the frames are gone, so
+              // touch nothing.
+              if (finalized)
+                return;
+
+              auto &stats = session.state.statistics;
+              const auto &frame = outbox.front();
+              stats.bytes_sent += frame.size();
+              if (frame.size() >= sizeof(messages::data))
+              {
+                std::uint16_t opc = 0;
+                std::memcpy(&opc, frame.data(), sizeof(opc));
+                if (ntohs(opc) == messages::DATA)
+                  ++stats.blocks_sent;
+              }
+
+              // Drain the next queued frame, if any, without waiting
+              // for another handler invocation.
+              if (pool)
+                pool->release(std::move(outbox.front()));
+              outbox.pop_front();
+              sending = false;
+              flush_sendmsg();
+            }) |
+            upon_error([&](int error) noexcept {
+              if (finalized)
+                return;
+
+              if (error != 0 && error != EAGAIN)
+                return this->finalize(
+                    std::error_code(error, std::system_category()));
+
+              // A dropped frame is recovered by protocol
+              // retransmission; keep draining the rest of the batch.
+              if (pool)
+                pool->release(std::move(outbox.front()));
+              outbox.pop_front();
+              sending = false;
+              flush_sendmsg();
+            });
+
+        ctx->scope.spawn(std::move(sendmsg));
+      },
+      [&]() noexcept { this->cleanup(); });
+}
+
 template <typename Receiver>
 auto client_sender::client_state<Receiver>::cleanup() noexcept -> void
 {
   auto &timer = session.state.timer;
   timer = ctx->timers.remove(timer);
+  retry.cancel(ctx->timers);
+  pace.cancel(ctx->timers);
+
+  if (pool)
+  {
+    // Recycle the transfer's buffers for the next session. The front
+    // frame stays alive while a spawned send still references it; only
+    // the frames queued behind it are recycled.
+    pool->release(std::move(session.state.buffer));
+    pool->release(std::move(recv_buffer));
+    while (outbox.size() > (sending ? 1UL : 0UL))
+    {
+      pool->release(std::move(outbox.back()));
+      outbox.pop_back();
+    }
+  }
 
   auto &tmpfile = session.state.tmp;
   if (!tmpfile.empty())
@@ -122,6 +290,63 @@ auto client_sender::client_state<Receiver>::cleanup() noexcept -> void
   finalized = true;
 }
 
+template <typename Receiver>
+auto client_sender::client_state<Receiver>::notify_metrics() noexcept -> void
+{
+  if (metrics == nullptr || !*metrics)
+    return;
+
+  try
+  {
+    (*metrics)(session.state.statistics);
+  }
+  catch (...) // GCOVR_EXCL_LINE
+  {
+    // A throwing sink must not tear down the completion path.
+  }
+}
+
+template <typename Receiver>
+auto client_sender::client_state<Receiver>::publish_progress() noexcept -> void
+{
+  if (progress == nullptr)
+    return;
+
+  const auto &stats = session.state.statistics;
+  progress->bytes.store(stats.bytes_sent + stats.bytes_received,
+                        std::memory_order_relaxed);
+  progress->blocks.store(stats.blocks_sent + stats.blocks_received,
+                         std::memory_order_relaxed);
+  progress->retransmits.store(stats.retransmits, std::memory_order_relaxed);
+}
+
+template <typename Receiver>
+auto client_sender::client_state<Receiver>::dump_trace() noexcept -> void
+{
+  if constexpr (detail::trace_ring::enabled)
+  {
+    // A diagnostics path must not take the teardown down with it.
+    try
+    {
+      const auto events = trace.snapshot();
+      if (events.empty())
+        return;
+
+      spdlog::warn("trace: {}: {} events, oldest first", local.string(),
+                   events.size());
+      for (const auto &event : events)
+        spdlog::warn(
+            "trace: +{}us opc={} block={}{}", event.time_ns / 1000, event.opc,
+            event.block,
+            (event.flags & detail::trace_ring::FLAG_RETRANSMIT) != 0 ? " rtx"
+                                                                     : "");
+    }
+    catch (...) // NOLINT(bugprone-empty-catch)
+    {
+    }
+  }
+}
+
 template <typename Receiver>
 auto client_sender::client_state<Receiver>::finalize(status_t status) noexcept
     -> void
@@ -130,6 +355,10 @@ auto client_sender::client_state<Receiver>::finalize(status_t status) noexcept
   if (!finalized)
   {
     cleanup();
+    notify_metrics();
+    publish_progress();
+    if (status.first != 0 || !status.second.empty())
+      dump_trace();
 
     set_value(std::move(receiver), std::move(status));
   }
@@ -143,6 +372,8 @@ auto client_sender::client_state<Receiver>::finalize(
   if (!finalized)
   {
     cleanup();
+    notify_metrics();
+    dump_trace();
 
     set_error(std::move(receiver), std::move(error));
   }
@@ -150,6 +381,31 @@ auto client_sender::client_state<Receiver>::finalize(
 
 template <typename Receiver>
 auto connect_t::state_t<Receiver>::start() noexcept -> void
+{
+  using namespace stdexec;
+  detail::try_with(
+      std::move(receiver),
+      [this] {
+        auto key = hostname + ":" + port;
+        if (auto cached = dns::address_cache::instance().lookup(key))
+        {
+          socket_address<sockaddr_in6> address = socket_address<sockaddr_in>(
+              reinterpret_cast<sockaddr *>(&cached->storage), cached->length);
+          return set_value(std::move(receiver), std::move(address));
+        }
+
+        // getaddrinfo can block for seconds on a slow resolver, so a
+        // cache miss resolves on its own thread and completes the
+        // receiver from there. The operation state outlives the thread:
+        // it stays stable until a completion function is called.
+        std::thread{[this, key = std::move(key)] { resolve(key); }}.detach();
+      },
+      []() noexcept {});
+}
+
+template <typename Receiver>
+auto connect_t::state_t<Receiver>::resolve(
+    const std::string &key) noexcept -> void
 {
   using namespace stdexec;
 
@@ -172,12 +428,23 @@ auto connect_t::state_t<Receiver>::start() noexcept -> void
                      make_error_code(dns::errc::address_not_found));
   }
 
-  socket_address<sockaddr_in6> address =
-      socket_address<sockaddr_in>(result->ai_addr, result->ai_addrlen);
-  freeaddrinfo(result);
-  result = nullptr;
+  detail::try_with(
+      std::move(receiver),
+      [&] {
+        dns::address_cache::instance().insert(key, result->ai_addr,
+                                              result->ai_addrlen);
+
+        socket_address<sockaddr_in6> address =
+            socket_address<sockaddr_in>(result->ai_addr, result->ai_addrlen);
+        freeaddrinfo(result);
+        result = nullptr;
 
-  set_value(std::move(receiver), std::move(address));
+        set_value(std::move(receiver), std::move(address));
+      },
+      [&]() noexcept {
+        if (result != nullptr)
+          freeaddrinfo(result);
+      });
 }
 
 template <typename Receiver>
@@ -211,44 +478,75 @@ auto put_file_t::state_t<Receiver>::send_wrq() noexcept -> void
   try_with(
       std::move(receiver),
       [&] {
-        auto opcode = htons(state.opc = messages::WRQ);
+        state.opc = messages::WRQ;
+
+        const auto opcode = messages::opcode_msg(messages::WRQ);
+        buffer.assign(opcode.begin(), opcode.end());
+
+        append_string(buffer, state.target.c_str());
+        append_string(buffer, messages::mode_to_str(
+                                  static_cast<messages::mode_t>(state.mode)));
 
-        buffer.resize(sizeof(opcode));
+        if (state.blksize != messages::DATALEN)
+        {
+          append_option(buffer, "blksize", state.blksize);
+          this->options_pending = true;
+        }
 
-        auto *msg = buffer.data();
-        std::memcpy(msg, &opcode, sizeof(opcode));
+        if (state.windowsize != messages::WINDOWSIZE_MIN)
+        {
+          append_option(buffer, "windowsize", state.windowsize);
+          this->options_pending = true;
+        }
 
-        const auto *begin = state.target.c_str();
-        const auto *end = begin + std::strlen(begin) + 1;
-        buffer.insert(buffer.end(), begin, end);
+        // Disclosing the transfer size lets the server preallocate the
+        // destination before the first data block lands (RFC 2349).
+        if (state.tsize > 0)
+        {
+          append_option(buffer, "tsize", state.tsize);
+          this->options_pending = true;
+        }
 
-        begin =
-            messages::mode_to_str(static_cast<messages::mode_t>(state.mode));
-        end = begin + std::strlen(begin) + 1;
-        buffer.insert(buffer.end(), begin, end);
+        if (state.timeout > 0)
+        {
+          append_option(buffer, "timeout", state.timeout);
+          this->options_pending = true;
+        }
 
         submit_sendmsg();
 
-        const auto &[_, avg_rtt] =
-            session_t::update_statistics(state.statistics);
-        auto &timer = state.timer = this->ctx->timers.remove(state.timer);
+        const auto rto =
+            session_t::update_statistics(state.statistics).rto;
 
-        // timers.add notifies the ctx event-loop by calling ctx.interrupt().
-        timer = this->ctx->timers.add(
-            2 * avg_rtt,
-            [&, retries = 0](auto) mutable noexcept {
+        // The deadline is registered once and rides a shared tick;
+        // later acks move it with a plain store instead of churning
+        // the timer queue.
+        this->retry.arm(
+            this->ctx->timers, rto, [&](auto expiries) noexcept {
               try_with(
                   std::move(receiver),
                   [&] {
                     constexpr auto MAX_RETRIES = 5;
-                    if (retries++ >= MAX_RETRIES)
+                    auto &stats = state.statistics;
+                    ++stats.timeouts;
+                    if (expiries > MAX_RETRIES)
+                    {
+                      recycle_window();
                       return this->finalize({0, "Timed out"});
+                    }
+
+                    if (state.windowsize > 1 && state.block_num > 0)
+                      return this->retransmit_window();
 
+                    // The resend makes the next sample ambiguous
+                    // (Karn's algorithm).
+                    stats.retransmitted = true;
+                    if (state.block_num > 0)
+                      ++stats.retransmits;
                     this->submit_sendmsg();
                   },
                   [&]() noexcept { this->cleanup(); });
-            },
-            2 * avg_rtt);
+            });
       },
       [&]() noexcept { this->cleanup(); });
 }
@@ -261,68 +559,246 @@ auto put_file_t::state_t<Receiver>::ack_handler(messages::ack ack) noexcept
   auto &session = this->session;
   auto &receiver = this->receiver;
 
+  // A plain ACK to an option-bearing WRQ means the options were declined.
+  this->options_fallback();
+
+  if (session.state.windowsize > 1)
+    return window_ack_handler(ack);
+
   try_with(
       std::move(receiver),
       [&] {
+        auto &state = session.state;
+        const auto in_order = ntohs(ack.block_num) == state.block_num;
+
         auto error = handle_ack(ack, std::addressof(session));
-        if (error || !session.state.file->is_open())
+        if (error || !state.read_open())
           return this->finalize({error, ""});
 
         submit_recvmsg();
-        submit_sendmsg();
-
-        const auto &[_, avg_rtt] =
-            session_t::update_statistics(session.state.statistics);
-        auto &timer = session.state.timer =
-            this->ctx->timers.remove(session.state.timer);
 
-        timer = this->ctx->timers.add(
-            2 * avg_rtt,
-            [&, retries = 0](auto) mutable noexcept {
-              try_with(
-                  std::move(receiver),
-                  [&] {
-                    constexpr auto MAX_RETRIES = 5;
-                    if (retries++ >= MAX_RETRIES)
-                      return this->finalize({0, "Timed out"});
+        if (!in_order)
+        {
+          // A duplicate ack for the last in-order block; the Nth in a
+          // row proves the in-flight DATA was lost, so it is resent
+          // ahead of the retry deadline (fast retransmit).
+          auto &stats = state.statistics;
+          ++stats.duplicate_acks;
+          if (++dup_acks < DUP_ACK_LIMIT)
+            return;
+
+          dup_acks = 0;
+          ++stats.retransmits;
+          // The resend makes the next sample ambiguous (Karn's
+          // algorithm).
+          stats.retransmitted = true;
+          this->trace.record(messages::DATA, state.block_num,
+                             trace_ring::FLAG_RETRANSMIT);
+        }
+        else
+        {
+          dup_acks = 0;
+        }
 
-                    this->submit_sendmsg();
-                  },
-                  [&]() noexcept { this->cleanup(); });
-            },
-            2 * avg_rtt);
+        submit_sendmsg();
+        // The frame is with the socket; the deferred advance now runs
+        // the next block's read while it is in flight.
+        state.advance_read();
+
+        const auto rto =
+            session_t::update_statistics(session.state.statistics).rto;
+        this->retry.reschedule(rto);
+        this->publish_progress();
       },
       [&]() noexcept { this->cleanup(); });
 }
 
 template <typename Receiver>
-auto put_file_t::state_t<Receiver>::submit_sendmsg() noexcept -> void
+auto put_file_t::state_t<Receiver>::window_ack_handler(
+    messages::ack ack) noexcept -> void
 {
-  using namespace stdexec;
   using namespace detail;
-  auto &ctx = this->ctx;
+  auto &session = this->session;
   auto &receiver = this->receiver;
-  auto &state = this->session.state;
-  auto &sockmsg = this->sockmsg;
-  auto &socket = this->socket;
+  auto &state = session.state;
 
   try_with(
       std::move(receiver),
       [&] {
-        sender auto sendmsg =
-            io::sendmsg(socket,
-                        socket_message{.address = sockmsg.address,
-                                       .buffers = state.buffer},
-                        0) |
-            then([](auto) noexcept {}) | upon_error([&](int error) noexcept {
-              this->finalize(std::error_code(error, std::system_category()));
-            });
+        auto advanced = window.empty(); // An empty window starts the transfer.
+        if (!window.empty())
+        {
+          // The block number of the oldest unacked block is
+          // block_num - window.size() + 1, modulo 2^16.
+          auto acked = static_cast<std::uint16_t>(
+              ntohs(ack.block_num) -
+              static_cast<std::uint16_t>(state.block_num - window.size()));
+
+          if (acked >= 1 && acked <= window.size())
+          {
+            // Acked frames recycle their storage for later blocks.
+            if (this->pool)
+            {
+              for (auto iter = window.begin(); iter != window.begin() + acked;
+                   ++iter)
+                this->pool->release(std::move(*iter));
+            }
+            window.erase(window.begin(), window.begin() + acked);
+            advanced = true;
+          }
+        }
 
-        ctx->scope.spawn(std::move(sendmsg));
+        if (advanced)
+        {
+          dup_acks = 0;
+          auto error = fill_window();
+          if (error)
+          {
+            recycle_window();
+            return this->finalize({error, ""});
+          }
+
+          // All data has been sent and acknowledged.
+          if (window.empty())
+            return this->finalize();
+        }
+        else
+        {
+          // A stale or duplicate ack. The Nth in a row proves the
+          // oldest in-flight block was lost, so go-back-N runs ahead
+          // of the retry deadline (fast retransmit); fewer may just
+          // be duplication on the return path.
+          ++state.statistics.duplicate_acks;
+          if (++dup_acks >= DUP_ACK_LIMIT)
+          {
+            dup_acks = 0;
+            retransmit_window();
+          }
+        }
+
+        submit_recvmsg();
+
+        const auto rto =
+            session_t::update_statistics(state.statistics).rto;
+        this->retry.reschedule(rto);
+        this->publish_progress();
       },
       [&]() noexcept { this->cleanup(); });
 }
 
+template <typename Receiver>
+auto put_file_t::state_t<Receiver>::fill_window() -> std::uint16_t
+{
+  auto &session = this->session;
+  auto &state = session.state;
+  auto &buffer = state.buffer;
+
+  // Drop the request bytes before the first data block is built.
+  if (window.empty() && state.block_num == 0)
+    buffer.clear();
+
+  while (window.size() < state.windowsize && state.read_pending())
+  {
+    // handle_ack sees a matching ack with pending data and builds
+    // the next DATA block into the session buffer.
+    auto error = handle_ack({.opc = htons(messages::ACK),
+                             .block_num = htons(state.block_num)},
+                            std::addressof(session));
+    if (error)
+      return error;
+
+    // Any NETASCII overflow is chained through the chunk source,
+    // so the copy is exactly the frame on the wire.
+    auto frame = this->pool ? this->pool->acquire(buffer.size())
+                            : std::vector<char>();
+    frame.assign(buffer.begin(), buffer.end());
+    window.emplace_back(std::move(frame));
+    this->enqueue_sendmsg(window.back());
+
+    // Flush as we go: the frame reaches the socket first, then the
+    // deferred advance runs the next block's read while it is in
+    // flight. The first flush starts the drain; the rest feed it.
+    this->flush_sendmsg();
+    state.advance_read();
+  }
+
+  return 0;
+}
+
+template <typename Receiver>
+auto put_file_t::state_t<Receiver>::retransmit_window() noexcept -> void
+{
+  // A non-empty outbox already covers these frames; don't stack
+  // another copy of the window onto a slow drain.
+  if (!this->outbox.empty())
+    return;
+
+  auto &stats = this->session.state.statistics;
+  stats.retransmits += window.size();
+  // The re-queued blocks make the next RTT sample ambiguous
+  // (Karn's algorithm).
+  stats.retransmitted = true;
+  this->trace.record(messages::DATA, this->session.state.block_num,
+                     detail::trace_ring::FLAG_RETRANSMIT);
+  for (const auto &pkt : window)
+    this->enqueue_sendmsg(pkt);
+
+  this->flush_sendmsg();
+}
+
+template <typename Receiver>
+auto put_file_t::state_t<Receiver>::recycle_window() noexcept -> void
+{
+  if (!this->pool)
+    return window.clear();
+
+  while (!window.empty())
+  {
+    this->pool->release(std::move(window.front()));
+    window.pop_front();
+  }
+}
+
+template <typename Receiver>
+auto put_file_t::state_t<Receiver>::oack_handler(
+    const char *msg, std::streamsize len) noexcept -> void
+{
+  auto &state = this->session.state;
+
+  if (this->options_pending)
+  {
+    auto opts = messages::parse_options(
+        {msg + sizeof(std::uint16_t),
+         static_cast<std::size_t>(len) - sizeof(std::uint16_t)});
+
+    // The server must not respond with larger option values than requested.
+    state.blksize = std::min(opts.blksize, state.blksize);
+    state.windowsize = std::min(opts.windowsize, state.windowsize);
+
+    // The agreed interval seeds the retransmission timeout and raises
+    // its ceiling until genuine samples justify less (RFC 2349).
+    if (state.timeout > 0 && opts.timeout > 0)
+    {
+      const auto negotiated = std::chrono::duration_cast<session_t::duration>(
+          std::chrono::seconds(opts.timeout));
+      state.statistics.rto_max = std::max(negotiated, session_t::TIMEOUT_MAX);
+      state.statistics.rto = negotiated;
+    }
+    this->options_pending = false;
+  }
+
+  // An OACK acknowledges the WRQ (RFC 2347), so the first data
+  // block is sent as if an ACK of block 0 had arrived.
+  ack_handler({.opc = htons(messages::ACK), .block_num = 0});
+}
+
+template <typename Receiver>
+auto put_file_t::state_t<Receiver>::submit_sendmsg() noexcept -> void
+{
+  this->enqueue_sendmsg(this->session.state.buffer);
+  this->flush_sendmsg();
+}
+
 template <typename Receiver>
 auto put_file_t::state_t<Receiver>::submit_recvmsg() noexcept -> void
 {
@@ -351,6 +827,11 @@ auto put_file_t::state_t<Receiver>::submit_recvmsg() noexcept -> void
                                              "Invalid server response."});
                     }
 
+                    // A foreign-TID datagram is dropped before it can
+                    // touch the session (RFC 1350).
+                    if (!this->filter_peer())
+                      return submit_recvmsg();
+
                     route_message(recv_buffer.data(), len);
                   },
                   [&]() noexcept { this->cleanup(); });
@@ -368,6 +849,9 @@ auto put_file_t::state_t<Receiver>::route_message(
     const char *msg, std::streamsize len) noexcept -> void
 {
   const auto *ack = reinterpret_cast<const messages::ack *>(msg);
+  if (len >= static_cast<std::streamsize>(sizeof(*ack)))
+    this->trace.record(ntohs(ack->opc), ntohs(ack->block_num));
+
   switch (ntohs(ack->opc))
   {
     case messages::ERROR:
@@ -376,6 +860,9 @@ auto put_file_t::state_t<Receiver>::route_message(
     case messages::ACK:
       return ack_handler(*ack);
 
+    case messages::OACK:
+      return oack_handler(msg, len);
+
     default: // non-ack/error messages are ignored.
       submit_recvmsg();
   }
@@ -384,18 +871,62 @@ auto put_file_t::state_t<Receiver>::route_message(
 template <typename Receiver>
 auto put_file_t::connect(Receiver &&receiver) -> state_t<Receiver>
 {
-  auto session =
-      session_t{.state = {.target = std::move(remote),
-                          .file = std::make_shared<std::fstream>(
-                              local, std::ios::in | std::ios::binary),
-                          .mode = mode}};
+  // Octet-mode reads are served from a file mapping; fall back to an
+  // fstream if the file cannot be mapped.
+  auto map = std::shared_ptr<filesystem::file_map>();
+  if (mode == messages::OCTET)
+  {
+    auto err = std::error_code();
+    map = filesystem::open_map(local, err);
+  }
+
+  auto file = map ? std::shared_ptr<std::fstream>()
+                  : std::make_shared<std::fstream>(local, std::ios::in |
+                                                              std::ios::binary);
 
-  return {{.session = std::move(session),
+  // The advertised transfer size is the octet count on the wire; a
+  // netascii conversion changes that count, so only octet-mode puts
+  // disclose it (RFC 2349).
+  auto tsize = std::uint64_t{};
+  if (map)
+  {
+    tsize = map->size();
+  }
+  else if (mode == messages::OCTET)
+  {
+    auto err = std::error_code();
+    const auto size = std::filesystem::file_size(local, err);
+    tsize = err ? 0 : size;
+  }
+
+  // Pooled buffers make steady-state batch transfers allocation-free.
+  auto buffer = pool ? pool->acquire(sizeof(messages::data) + 2UL * blksize)
+                     : std::vector<char>();
+  auto recv_buffer =
+      pool ? pool->acquire(messages::DATAMSG_MAXLEN) : std::vector<char>();
+  recv_buffer.resize(messages::DATAMSG_MAXLEN);
+
+  auto session = session_t{.state = {.target = std::move(remote),
+                                     .buffer = std::move(buffer),
+                                     .file = std::move(file),
+                                     .map = std::move(map),
+                                     .tsize = tsize,
+                                     .blksize = blksize,
+                                     .windowsize = windowsize,
+                                     .mode = mode,
+                                     .timeout = timeout}};
+
+  return {{.recv_buffer = std::move(recv_buffer),
+           .session = std::move(session),
            .sockmsg = socket_message{.address = {server_addr}},
            .local = std::move(local),
            .socket = ctx->poller.emplace(AF_INET, SOCK_DGRAM, IPPROTO_UDP),
            .receiver = std::forward<Receiver>(receiver),
-           .ctx = ctx}};
+           .ctx = ctx,
+           .pool = pool,
+           .metrics = metrics,
+           .progress = progress,
+           .pace = detail::pace_bucket(rate)}};
 }
 
 template <typename Receiver>
@@ -416,21 +947,44 @@ auto get_file_t::state_t<Receiver>::send_rrq() noexcept -> void
   try_with(
       std::move(receiver),
       [&] {
-        auto opcode = htons(state.opc = messages::RRQ);
+        state.opc = messages::RRQ;
 
-        buffer.resize(sizeof(opcode));
+        const auto opcode = messages::opcode_msg(messages::RRQ);
+        buffer.assign(opcode.begin(), opcode.end());
 
-        auto *msg = buffer.data();
-        std::memcpy(msg, &opcode, sizeof(opcode));
+        append_string(buffer, state.target.c_str());
+        append_string(buffer, messages::mode_to_str(
+                                  static_cast<messages::mode_t>(state.mode)));
 
-        const auto *begin = state.target.c_str();
-        const auto *end = begin + std::strlen(begin) + 1;
-        buffer.insert(buffer.end(), begin, end);
+        if (state.blksize != messages::DATALEN)
+        {
+          append_option(buffer, "blksize", state.blksize);
+          this->options_pending = true;
+        }
 
-        begin =
-            messages::mode_to_str(static_cast<messages::mode_t>(state.mode));
-        end = begin + std::strlen(begin) + 1;
-        buffer.insert(buffer.end(), begin, end);
+        if (state.windowsize != messages::WINDOWSIZE_MIN)
+        {
+          append_option(buffer, "windowsize", state.windowsize);
+          this->options_pending = true;
+        }
+
+        // A zero tsize asks the server to disclose the transfer size in
+        // its OACK so the destination can be preallocated (RFC 2349);
+        // servers that decline options fall back to a plain transfer.
+        append_option(buffer, "tsize", 0);
+        this->options_pending = true;
+
+        if (state.timeout > 0)
+          append_option(buffer, "timeout", state.timeout);
+
+        // One multicast feed can serve a whole fleet of readers
+        // (RFC 2090). The option carries no request value.
+        if (state.multicast)
+        {
+          append_string(buffer, "multicast");
+          append_string(buffer, "");
+          this->options_pending = true;
+        }
 
         submit_sendmsg();
       },
@@ -447,23 +1001,60 @@ auto get_file_t::state_t<Receiver>::data_handler(
   auto &block_num = session.state.block_num;
   auto &buffer = session.state.buffer;
 
+  // A plain DATA response to an option-bearing RRQ means the
+  // options were declined.
+  this->options_fallback();
+
   try_with(
       std::move(receiver),
       [&] {
         const auto *data = reinterpret_cast<const messages::ack *>(msg);
+        const auto prev_block = block_num;
+        session.state.statistics.bytes_received +=
+            static_cast<std::uint64_t>(len);
         auto error = handle_data(data, len, std::addressof(session));
         if (error)
           return this->finalize({error, ""});
 
-        if (ntohs(data->block_num) == block_num)
+        // handle_data advances block_num only for the next expected block.
+        const auto accepted =
+            block_num == static_cast<std::uint16_t>(prev_block + 1);
+        // A duplicate of the current block means the sender missed our
+        // last ack; any other out-of-order block signals a loss inside
+        // the window (RFC 7440). Both re-ack the last good block so
+        // the sender can resynchronize (and count towards its
+        // duplicate-ack fast retransmit), but a gap is acked only
+        // once: every remaining block of the broken window would
+        // repeat the same signal.
+        const auto duplicate =
+            !accepted && ntohs(data->block_num) == block_num;
+        const auto gap = !accepted && !duplicate && !this->gap_acked;
+        const auto resync = duplicate || gap;
+        if (gap)
+          this->gap_acked = true;
+
+        if (accepted)
         {
-          buffer.resize(sizeof(messages::ack));
+          ++this->unacked;
+          ++session.state.statistics.blocks_received;
+          this->gap_acked = false;
+          this->publish_progress();
+        }
 
-          auto *ack = reinterpret_cast<messages::ack *>(buffer.data());
-          ack->opc = htons(messages::ACK);
-          ack->block_num = data->block_num;
+        // With windowed transfers (RFC 7440), only the last block of
+        // each window is acked; short (final) blocks close the file
+        // and are always acked.
+        if ((accepted && (this->unacked >= session.state.windowsize ||
+                          !session.state.file->is_open())) ||
+            resync)
+        {
+          const auto ack = messages::ack_msg(block_num);
+          buffer.assign(ack.begin(), ack.end());
+          this->trace.record(messages::ACK, block_num,
+                             resync ? trace_ring::FLAG_RETRANSMIT : 0);
 
           submit_sendmsg();
+          this->unacked = 0;
         }
 
         if (!session.state.file->is_open())
@@ -481,50 +1072,121 @@ auto get_file_t::state_t<Receiver>::data_handler(
       [&]() noexcept { this->cleanup(); });
 }
 
+template <typename Receiver>
+auto get_file_t::state_t<Receiver>::oack_handler(
+    const char *msg, std::streamsize len) noexcept -> void
+{
+  using namespace detail;
+  auto &receiver = this->receiver;
+  auto &state = this->session.state;
+  auto &buffer = state.buffer;
+
+  try_with(
+      std::move(receiver),
+      [&] {
+        if (this->options_pending)
+        {
+          auto opts = messages::parse_options(
+              {msg + sizeof(std::uint16_t),
+               static_cast<std::size_t>(len) - sizeof(std::uint16_t)});
+
+          // The server must not respond with larger option values
+          // than requested.
+          state.blksize = std::min(opts.blksize, state.blksize);
+          state.windowsize = std::min(opts.windowsize, state.windowsize);
+          this->recv_buffer.resize(sizeof(messages::data) + state.blksize);
+
+          // Growing the temporary to the disclosed size up front spares
+          // the filesystem a piecemeal extension on every flush; a
+          // netascii transfer's final size differs from its size on the
+          // wire, so only octet-mode gets preallocate (RFC 2349).
+          state.tsize = opts.tsize;
+          if (opts.tsize > 0 && state.mode == messages::OCTET)
+          {
+            auto err = std::error_code();
+            std::filesystem::resize_file(state.tmp, opts.tsize, err);
+          }
+
+          // The agreed interval seeds the retransmission timeout and
+          // raises its ceiling until genuine samples justify less
+          // (RFC 2349).
+          if (state.timeout > 0 && opts.timeout > 0)
+          {
+            const auto negotiated =
+                std::chrono::duration_cast<session_t::duration>(
+                    std::chrono::seconds(opts.timeout));
+            state.statistics.rto_max =
+                std::max(negotiated, session_t::TIMEOUT_MAX);
+            state.statistics.rto = negotiated;
+          }
+
+          // A multicast grant (RFC 2090) names a group this transport
+          // cannot subscribe to: the poller exposes no group-membership
+          // control yet. The grant is declined with error code 8, as
+          // RFC 2347 requires for an unacceptable OACK, so the server
+          // tears the feed down instead of running it out to its
+          // timeout.
+          if (state.multicast)
+          {
+            state.multicast = opts.multicast;
+            state.mc_master = opts.mc_master;
+            if (opts.multicast)
+            {
+              static constexpr auto refused = errors::msg(
+                  messages::OPTION_REFUSED, "Multicast is not supported.");
+              this->enqueue_sendmsg({refused.begin(), refused.end()});
+              this->flush_sendmsg();
+              return this->finalize(
+                  {0, "Multicast is not supported by the transport."});
+            }
+          }
+          this->options_pending = false;
+        }
+
+        // An OACK is acknowledged with an ACK of block 0 (RFC 2347).
+        const auto ack = messages::ack_msg(0);
+        buffer.assign(ack.begin(), ack.end());
+
+        submit_sendmsg();
+        submit_recvmsg();
+      },
+      [&]() noexcept { this->cleanup(); });
+}
+
 template <typename Receiver>
 auto get_file_t::state_t<Receiver>::submit_sendmsg() noexcept -> void
 {
-  using namespace stdexec;
   using namespace detail;
   auto &receiver = this->receiver;
-  auto &sockmsg = this->sockmsg;
-  auto &socket = this->socket;
   auto &state = this->session.state;
   auto &file = state.file;
   auto &ctx = this->ctx;
 
-  const auto &[_, avg_rtt] = session_t::update_statistics(state.statistics);
-  auto &timer = state.timer = ctx->timers.remove(state.timer);
+  const auto rto = session_t::update_statistics(state.statistics).rto;
 
   try_with(
       std::move(receiver),
       [&] {
-        sender auto sendmsg =
-            io::sendmsg(socket,
-                        socket_message{.address = sockmsg.address,
-                                       .buffers = state.buffer},
-                        0) |
-            then([](auto) noexcept {}) | upon_error([&](int error) noexcept {
-              if (error != 0 && error != EAGAIN)
-                this->finalize(std::error_code(error, std::system_category()));
-            });
-
-        ctx->scope.spawn(std::move(sendmsg));
-
-        // timers.add notifies the ctx event-loop by calling ctx.interrupt().
-        timer = ctx->timers.add(
-            // NOLINTNEXTLINE(cppcoreguidelines-avoid-magic-numbers)
-            5 * avg_rtt, [&](auto) noexcept {
-              try_with(
-                  std::move(receiver),
-                  [&] {
-                    if (file->is_open())
-                      return this->finalize({0, "Timed out"});
-
-                    this->finalize();
-                  },
-                  [&]() noexcept { this->cleanup(); });
-            });
+        this->enqueue_sendmsg(state.buffer);
+        this->flush_sendmsg();
+
+        // The inactivity deadline spans a full retransmission round
+        // trip on the server side before the transfer is abandoned;
+        // each send moves it with a plain store.
+        this->retry.arm(ctx->timers, 2 * rto, [&](auto) noexcept {
+          try_with(
+              std::move(receiver),
+              [&] {
+                if (file->is_open())
+                {
+                  ++state.statistics.timeouts;
+                  return this->finalize({0, "Timed out"});
+                }
+
+                this->finalize();
+              },
+              [&]() noexcept { this->cleanup(); });
+        });
       },
       [&]() noexcept { this->cleanup(); });
 }
@@ -557,6 +1219,11 @@ auto get_file_t::state_t<Receiver>::submit_recvmsg() noexcept -> void
                                              "Invalid server response."});
                     }
 
+                    // A foreign-TID datagram is dropped before it can
+                    // touch the session (RFC 1350).
+                    if (!this->filter_peer())
+                      return submit_recvmsg();
+
                     route_message(recv_buffer.data(), len);
                   },
                   [&]() noexcept { this->cleanup(); });
@@ -574,6 +1241,10 @@ auto get_file_t::state_t<Receiver>::route_message(
     const char *msg, std::streamsize len) noexcept -> void
 {
   const auto *opc = reinterpret_cast<const std::uint16_t *>(msg);
+  const auto *head = reinterpret_cast<const messages::ack *>(msg);
+  if (len >= static_cast<std::streamsize>(sizeof(*head)))
+    this->trace.record(ntohs(head->opc), ntohs(head->block_num));
+
   switch (ntohs(*opc))
   {
     case messages::ERROR:
@@ -582,6 +1253,9 @@ auto get_file_t::state_t<Receiver>::route_message(
     case messages::DATA:
       return data_handler(msg, len);
 
+    case messages::OACK:
+      return oack_handler(msg, len);
+
     default: // non-data/error messages are ignored.
       submit_recvmsg();
   }
@@ -593,21 +1267,41 @@ auto get_file_t::connect(Receiver &&receiver) -> state_t<Receiver>
   if (mode == messages::MAIL)
     throw std::invalid_argument("Mail mode is not allowed in read requests.");
 
-  auto tmpfile = std::filesystem::temp_directory_path() / local.filename();
+  // The temporary lives beside the destination so the completing
+  // rename stays on one filesystem instead of degrading to a copy.
+  auto tmpfile = filesystem::tmpname(local);
   auto file = std::make_shared<std::fstream>(
       tmpfile, std::ios::out | std::ios::trunc | std::ios::binary);
 
-  auto session = session_t{.state = {.target = std::move(remote),
-                                     .tmp = std::move(tmpfile),
-                                     .file = std::move(file),
-                                     .mode = mode}};
+  // Pooled buffers make steady-state batch transfers allocation-free.
+  auto buffer =
+      pool ? pool->acquire(messages::DATAMSG_MAXLEN) : std::vector<char>();
+  auto recv_buffer =
+      pool ? pool->acquire(messages::DATAMSG_MAXLEN) : std::vector<char>();
+  recv_buffer.resize(messages::DATAMSG_MAXLEN);
 
-  return {{.session = std::move(session),
+  auto session =
+      session_t{.state = {.target = std::move(remote),
+                          .tmp = std::move(tmpfile),
+                          .buffer = std::move(buffer),
+                          .file = std::move(file),
+                          .blksize = blksize,
+                          .windowsize = windowsize,
+                          .mode = mode,
+                          .timeout = timeout,
+                          .multicast = multicast && mode == messages::OCTET}};
+
+  return {{.recv_buffer = std::move(recv_buffer),
+           .session = std::move(session),
            .sockmsg = socket_message{.address = {server_addr}},
            .local = std::move(local),
            .socket = ctx->poller.emplace(AF_INET, SOCK_DGRAM, IPPROTO_UDP),
            .receiver = std::forward<Receiver>(receiver),
-           .ctx = ctx}};
+           .ctx = ctx,
+           .pool = pool,
+           .metrics = metrics,
+           .progress = progress,
+           .pace = detail::pace_bucket(rate)}};
 }
 // GCOVR_EXCL_STOP
 } // namespace tftp::client.
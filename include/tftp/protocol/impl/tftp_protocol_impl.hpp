@@ -23,6 +23,134 @@
 #include "tftp/protocol/tftp_protocol.hpp"
 /** @brief TFTP related utilities. */
 namespace tftp {
+/** @brief Defines internal tftp implementation details. */
+namespace detail {
+/**
+ * @brief Case-insensitive comparison of two option names.
+ * @param lhs The first option name.
+ * @param rhs The second option name.
+ * @returns true if the names match ignoring case, false otherwise.
+ */
+constexpr auto option_name_equal(std::string_view lhs,
+                                 std::string_view rhs) noexcept -> bool
+{
+  constexpr auto to_lower = [](char chr) {
+    return (chr >= 'A' && chr <= 'Z') ? static_cast<char>(chr - 'A' + 'a')
+                                      : chr;
+  };
+
+  if (lhs.size() != rhs.size())
+    return false;
+
+  for (std::size_t i = 0; i < lhs.size(); ++i)
+  {
+    if (to_lower(lhs[i]) != to_lower(rhs[i]))
+      return false;
+  }
+  return true;
+}
+
+/**
+ * @brief Parses an unsigned decimal option value.
+ * @param value The option value string.
+ * @param[out] out The parsed value.
+ * @returns true if the value is a valid unsigned decimal, false otherwise.
+ */
+constexpr auto parse_option_value(std::string_view value,
+                                  std::uint64_t &out) noexcept -> bool
+{
+  if (value.empty())
+    return false;
+
+  std::uint64_t parsed = 0;
+  for (const auto chr : value)
+  {
+    if (chr < '0' || chr > '9')
+      return false;
+
+    constexpr auto MAX_PARSEABLE = (UINT64_MAX - 9) / 10;
+    if (parsed > MAX_PARSEABLE)
+      return false;
+
+    parsed = parsed * 10 + static_cast<std::uint64_t>(chr - '0');
+  }
+
+  out = parsed;
+  return true;
+}
+
+/**
+ * @brief Parses a dotted-quad IPv4 address.
+ * @param value The address string.
+ * @param[out] out The parsed address in host byte order.
+ * @returns true if the value is a well-formed dotted quad, false otherwise.
+ */
+constexpr auto parse_option_addr(std::string_view value,
+                                 std::uint32_t &out) noexcept -> bool
+{
+  std::uint32_t addr = 0;
+  for (auto octet = 0; octet < 4; ++octet)
+  {
+    // The first three fields end at a dot, the last at the string end.
+    const auto dot = value.find('.');
+    if ((octet < 3) != (dot != std::string_view::npos))
+      return false;
+
+    std::uint64_t parsed = 0;
+    if (!parse_option_value(value.substr(0, dot), parsed) || parsed > 255)
+      return false;
+
+    addr = (addr << 8U) | static_cast<std::uint32_t>(parsed);
+    value.remove_prefix(dot == std::string_view::npos ? value.size()
+                                                      : dot + 1);
+  }
+
+  out = addr;
+  return true;
+}
+
+/**
+ * @brief Parses an RFC 2090 multicast option value ("addr,port,mc").
+ * @details The address and port fields may be empty: an OACK to an
+ * already-subscribed client carries only a master-client change.
+ * @param value The option value string.
+ * @param[in,out] opts The option set to fill in.
+ * @returns true if the value is well formed, false otherwise.
+ */
+constexpr auto parse_multicast_value(std::string_view value,
+                                     messages::options_t &opts) noexcept
+    -> bool
+{
+  const auto first = value.find(',');
+  if (first == std::string_view::npos)
+    return false;
+
+  const auto second = value.find(',', first + 1);
+  if (second == std::string_view::npos)
+    return false;
+
+  const auto addr = value.substr(0, first);
+  const auto port = value.substr(first + 1, second - first - 1);
+  const auto master = value.substr(second + 1);
+
+  std::uint32_t parsed_addr = 0;
+  if (!addr.empty() && !parse_option_addr(addr, parsed_addr))
+    return false;
+
+  std::uint64_t parsed_port = 0;
+  if (!port.empty() &&
+      (!parse_option_value(port, parsed_port) || parsed_port > UINT16_MAX))
+    return false;
+
+  if (master != "0" && master != "1")
+    return false;
+
+  opts.mc_addr = parsed_addr;
+  opts.mc_port = static_cast<std::uint16_t>(parsed_port);
+  opts.mc_master = master == "1";
+  return true;
+}
+} // namespace detail
 constexpr auto messages::mode_to_str(messages::mode_t mode) -> const char *
 {
   switch (mode)
@@ -40,5 +168,80 @@ constexpr auto messages::mode_to_str(messages::mode_t mode) -> const char *
       return "";
   }
 }
+
+constexpr auto messages::parse_options(std::string_view body) noexcept
+    -> options_t
+{
+  using namespace detail;
+
+  auto opts = options_t{};
+  while (!body.empty())
+  {
+    auto name_end = body.find('\0');
+    if (name_end == std::string_view::npos)
+      break;
+
+    auto name = body.substr(0, name_end);
+    body.remove_prefix(name_end + 1);
+
+    auto value_end = body.find('\0');
+    if (value_end == std::string_view::npos)
+      break;
+
+    auto value = body.substr(0, value_end);
+    body.remove_prefix(value_end + 1);
+
+    // The multicast value is structured rather than numeric (RFC 2090).
+    if (option_name_equal(name, "multicast"))
+    {
+      opts.multicast = parse_multicast_value(value, opts);
+      continue;
+    }
+
+    std::uint64_t parsed = 0;
+    if (!parse_option_value(value, parsed))
+      continue;
+
+    if (option_name_equal(name, "blksize") && parsed >= BLKSIZE_MIN &&
+        parsed <= BLKSIZE_MAX)
+    {
+      opts.blksize = static_cast<std::uint16_t>(parsed);
+    }
+    else if (option_name_equal(name, "windowsize") &&
+             parsed >= WINDOWSIZE_MIN && parsed <= WINDOWSIZE_MAX)
+    {
+      opts.windowsize = static_cast<std::uint16_t>(parsed);
+    }
+    else if (option_name_equal(name, "tsize"))
+    {
+      opts.tsize = parsed;
+    }
+    else if (option_name_equal(name, "timeout") && parsed >= TIMEOUT_OPT_MIN &&
+             parsed <= TIMEOUT_OPT_MAX)
+    {
+      opts.timeout = static_cast<std::uint8_t>(parsed);
+    }
+  }
+
+  return opts;
+}
+
+constexpr auto messages::ack_msg(std::uint16_t block_num) noexcept
+    -> std::array<char, sizeof(ack)>
+{
+  using detail::htons_;
+
+  const auto msg = ack{.opc = htons_(ACK), .block_num = htons_(block_num)};
+  return std::bit_cast<std::array<char, sizeof(msg)>>(msg);
+}
+
+constexpr auto messages::opcode_msg(opcode_t opc) noexcept
+    -> std::array<char, sizeof(std::uint16_t)>
+{
+  using detail::htons_;
+
+  const auto code = htons_(static_cast<std::uint16_t>(opc));
+  return std::bit_cast<std::array<char, sizeof(code)>>(code);
+}
 } // namespace tftp
 #endif // TFTP_PROTOCOL_IMPL_HPP
@@ -20,6 +20,9 @@
 #ifndef TFTP_SESSION_IMPL_HPP
 #define TFTP_SESSION_IMPL_HPP
 #include "tftp/protocol/tftp_session.hpp"
+
+#include <bit>
+#include <utility>
 /** @brief TFTP related utilities. */
 namespace tftp {
 inline auto session_t::update_statistics(
@@ -27,16 +30,43 @@ inline auto session_t::update_statistics(
     -> session_t::state_t::statistics_t &
 {
   using namespace std::chrono;
+  using statistics_t = state_t::statistics_t;
 
-  auto &[start_time, avg_rtt] = statistics;
   auto now = clock::now();
-  auto rtt = duration_cast<duration>(now - start_time);
+  auto rtt = duration_cast<duration>(now - statistics.start_time);
+  statistics.start_time = now;
+
+  // Karn's algorithm: an interval that covered a retransmission
+  // cannot be attributed to one transmission, so it is not sampled.
+  if (std::exchange(statistics.retransmitted, false))
+    return statistics;
+
+  // Record the sample in the log2 histogram; the last bucket
+  // aggregates everything at or beyond 2^(RTT_BUCKETS-1) ms.
+  auto sample = static_cast<std::uint64_t>(std::max<std::int64_t>(
+      rtt.count(), 0));
+  auto bucket = std::min<std::size_t>(std::bit_width(sample),
+                                      statistics_t::RTT_BUCKETS - 1);
+  ++statistics.rtt_histogram[bucket];
 
-  avg_rtt = avg_rtt * 3 / 4 + rtt / 4;
-  avg_rtt = std::min(avg_rtt, TIMEOUT_MAX);
-  avg_rtt = std::max(avg_rtt, TIMEOUT_MIN);
+  // Jacobson/Karels estimation with the RFC 6298 constants: the
+  // first sample seeds the estimators, later samples blend in with
+  // alpha = 1/8 and beta = 1/4.
+  if (!std::exchange(statistics.sampled, true))
+  {
+    statistics.srtt = rtt;
+    statistics.rttvar = rtt / 2;
+  }
+  else
+  {
+    statistics.rttvar =
+        statistics.rttvar * 3 / 4 + abs(statistics.srtt - rtt) / 4;
+    statistics.srtt = statistics.srtt * 7 / 8 + rtt / 8;
+  }
 
-  start_time = now;
+  statistics.rto = statistics.srtt + 4 * statistics.rttvar;
+  statistics.rto = std::min(statistics.rto, statistics.rto_max);
+  statistics.rto = std::max(statistics.rto, TIMEOUT_MIN);
 
   return statistics;
 }
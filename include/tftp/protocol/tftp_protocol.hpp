@@ -37,7 +37,7 @@ struct messages {
    * @brief Protocol defined operations (opcodes).
    * These are the valid TFTP operation codes as defined in RFC 1350.
    */
-  enum opcode_t : std::uint16_t { RRQ = 1, WRQ, DATA, ACK, ERROR };
+  enum opcode_t : std::uint16_t { RRQ = 1, WRQ, DATA, ACK, ERROR, OACK };
 
   /**
    * @brief Protocol defined transfer modes.
@@ -60,6 +60,8 @@ struct messages {
     UNKNOWN_TID,
     FILE_ALREADY_EXISTS,
     NO_SUCH_USER,
+    // Option negotiation failed (RFC 2347).
+    OPTION_REFUSED,
     // Errors below this point are all ALIASES to NOT_DEFINED.
     TIMED_OUT
   };
@@ -110,6 +112,73 @@ struct messages {
   static constexpr auto DATALEN = 512UL;
   /** @brief The maximum total size of a DATA message (header + payload). */
   static constexpr auto DATAMSG_MAXLEN = sizeof(data) + DATALEN;
+
+  /** @brief The minimum negotiable block size (RFC 2348). */
+  static constexpr auto BLKSIZE_MIN = 8UL;
+  /** @brief The maximum negotiable block size (RFC 2348). */
+  static constexpr auto BLKSIZE_MAX = 65464UL;
+
+  /** @brief The minimum negotiable window size (RFC 7440). */
+  static constexpr auto WINDOWSIZE_MIN = 1UL;
+  /** @brief The maximum negotiable window size (RFC 7440). */
+  static constexpr auto WINDOWSIZE_MAX = 65535UL;
+
+  /** @brief The minimum negotiable timeout in seconds (RFC 2349). */
+  static constexpr auto TIMEOUT_OPT_MIN = 1UL;
+  /** @brief The maximum negotiable timeout in seconds (RFC 2349). */
+  static constexpr auto TIMEOUT_OPT_MAX = 255UL;
+
+  /**
+   * @brief Negotiated option values (RFC 2347).
+   * Holds the option values carried by a request or an OACK message.
+   */
+  struct options_t {
+    /** @brief The transfer size in octets, or 0 if absent (RFC 2349). */
+    std::uint64_t tsize = 0;
+    /** @brief The negotiated block size (RFC 2348). */
+    std::uint16_t blksize = DATALEN;
+    /** @brief The negotiated window size (RFC 7440). */
+    std::uint16_t windowsize = WINDOWSIZE_MIN;
+    /** @brief The negotiated timeout in seconds, or 0 if absent (RFC 2349). */
+    std::uint8_t timeout = 0;
+    /** @brief The advertised multicast group address in host byte
+     * order, or 0 if absent (RFC 2090). */
+    std::uint32_t mc_addr = 0;
+    /** @brief The advertised multicast port, or 0 if absent (RFC 2090). */
+    std::uint16_t mc_port = 0;
+    /** @brief Whether this client was elected master (RFC 2090). */
+    bool mc_master = false;
+    /** @brief Whether the message carried a well-formed multicast
+     * option (RFC 2090). */
+    bool multicast = false;
+  };
+
+  /**
+   * @brief Parses the option region of a request or OACK message.
+   * @details The option region is a sequence of null-terminated
+   * name/value string pairs following the fixed message fields.
+   * Unrecognized options and malformed values are ignored.
+   * @param body The option region (excluding the opcode).
+   * @returns The parsed option values, defaulted where absent.
+   */
+  static constexpr auto parse_options(std::string_view body) noexcept
+      -> options_t;
+
+  /**
+   * @brief Builds a wire-format ACK message on the stack.
+   * @param block_num The block number to acknowledge (host byte order).
+   * @returns A byte array with all fields in network byte order.
+   */
+  static constexpr auto ack_msg(std::uint16_t block_num) noexcept
+      -> std::array<char, sizeof(ack)>;
+
+  /**
+   * @brief Builds the opcode prefix of a request message.
+   * @param opc The request opcode.
+   * @returns A byte array containing the opcode in network byte order.
+   */
+  static constexpr auto opcode_msg(opcode_t opc) noexcept
+      -> std::array<char, sizeof(std::uint16_t)>;
 };
 // NOLINTEND(performance-enum-size)
 
@@ -182,6 +251,9 @@ struct errors {
       case ILLEGAL_OPERATION:
         return "Illegal operation.";
 
+      case OPTION_REFUSED:
+        return "Option negotiation failed.";
+
       case TIMED_OUT:
         return "Timed out.";
 
@@ -20,11 +20,16 @@
 #pragma once
 #ifndef TFTP_SESSION_HPP
 #define TFTP_SESSION_HPP
+#include "tftp/detail/generator.hpp"
+#include "tftp/filesystem.hpp"
+
 #include <net/timers/timers.hpp>
 
+#include <array>
 #include <cstdint>
 #include <filesystem>
 #include <fstream>
+#include <span>
 #include <vector>
 /** @brief TFTP related utilities. */
 namespace tftp {
@@ -47,10 +52,14 @@ struct session_t {
   using socket_type = io::socket::native_socket_type;
   /** @brief The invalid socket constant. */
   static constexpr auto INVALID_SOCKET = io::socket::INVALID_SOCKET;
+  /** @brief A coroutine that yields prepared outbound DATA blocks. */
+  using chunk_source = detail::generator<std::span<const char>>;
   /** @brief Timeout min value. */
   static constexpr auto TIMEOUT_MIN = duration(2);
   /** @brief Timeout max value. */
   static constexpr auto TIMEOUT_MAX = duration(200);
+  /** @brief The writeback flush threshold in bytes. */
+  static constexpr auto WRITEBACK_MAX = 1UL << 20UL;
 
   /** @brief The session state. */
   struct state_t {
@@ -62,25 +71,209 @@ struct session_t {
     std::vector<char> buffer;
     /** @brief The fstream associated with the operation. */
     std::shared_ptr<std::fstream> file;
-    /** @brief RTT statistics aggregate type. */
+    /** @brief A read-only file mapping used for octet-mode reads. */
+    std::shared_ptr<filesystem::file_map> map;
+    /** @brief The read offset into the file mapping. */
+    std::size_t map_offset = 0;
+    /** @brief Set once the final short DATA block has been built from
+     * the file mapping. */
+    bool map_eof = false;
+    /** @brief Coalesced inbound payloads awaiting a flush. */
+    std::vector<char> writeback;
+    /** @brief The read stage: a coroutine that keeps a small ring of
+     * prepared DATA blocks ahead of the block in flight. */
+    chunk_source source;
+    /** @brief The cursor at the next prepared block in `source`. */
+    chunk_source::iterator chunk;
+    /** @brief The cursor still sits on an adopted block and awaits
+     * its deferred advance. */
+    bool advance_pending = false;
+    /** @brief Transfer statistics aggregate type.
+     * @details Counters are plain integers: the hot path runs entirely
+     * on the session's context thread, and the aggregate stays movable
+     * with the rest of the session state. */
     struct statistics_t {
+      /** @brief The number of logarithmic RTT histogram buckets. */
+      static constexpr auto RTT_BUCKETS = 8UL;
+
       /** @brief Used to mark the start time of an interval. */
       timestamp start_time{clock::now() - TIMEOUT_MAX / 2};
-      /** @brief The aggregate avg round trip time. */
-      duration avg_rtt{TIMEOUT_MAX};
+      /** @brief The smoothed round trip time (RFC 6298 SRTT). */
+      duration srtt{0};
+      /** @brief The round trip time variance (RFC 6298 RTTVAR). */
+      duration rttvar{0};
+      /** @brief The retransmission timeout computed from srtt and
+       * rttvar, clamped to [TIMEOUT_MIN, rto_max]. */
+      duration rto{TIMEOUT_MAX};
+      /** @brief The RTO clamp ceiling; a negotiated timeout option
+       * raises it above TIMEOUT_MAX (RFC 2349). */
+      duration rto_max{TIMEOUT_MAX};
+      /** @brief Header and payload bytes handed to the socket. */
+      std::uint64_t bytes_sent = 0;
+      /** @brief Header and payload bytes accepted from the socket. */
+      std::uint64_t bytes_received = 0;
+      /** @brief DATA blocks handed to the socket, retransmits included. */
+      std::uint64_t blocks_sent = 0;
+      /** @brief In-order DATA blocks accepted from the socket. */
+      std::uint64_t blocks_received = 0;
+      /** @brief DATA blocks queued again after a loss signal. */
+      std::uint64_t retransmits = 0;
+      /** @brief Stale or duplicate acks observed (RFC 7440). */
+      std::uint64_t duplicate_acks = 0;
+      /** @brief Retry timer expiries. */
+      std::uint64_t timeouts = 0;
+      /** @brief RTT samples bucketed by log2 of the milliseconds. */
+      std::array<std::uint32_t, RTT_BUCKETS> rtt_histogram{};
+      /** @brief Whether an RTT sample has seeded srtt and rttvar. */
+      bool sampled = false;
+      /** @brief The current interval covers a retransmission, so its
+       * sample is ambiguous and must be discarded (Karn's algorithm). */
+      bool retransmitted = false;
     };
-    /** @brief RTT statistics. */
+    /** @brief Transfer statistics. */
     statistics_t statistics;
     /** @brief A timer id associated to the TFTP session. */
     timer_id timer{INVALID_TIMER};
     /** @brief The local socket that the session is keyed on. */
     socket_type socket{INVALID_SOCKET};
+    /** @brief The transfer size in octets, or 0 if unknown (RFC 2349). */
+    std::uint64_t tsize = 0;
+    /** @brief The negotiated data block size (RFC 2348). */
+    std::uint16_t blksize = 512;
+    /** @brief The negotiated window size (RFC 7440). */
+    std::uint16_t windowsize = 1;
     /** @brief The current protocol block number. */
     std::uint16_t block_num = 0;
     /** @brief The file operation. */
     std::uint16_t opc = 0;
     /** @brief The operating mode. */
     std::uint8_t mode = 0;
+    /** @brief The requested timeout in seconds, or 0 if absent (RFC 2349). */
+    std::uint8_t timeout = 0;
+    /** @brief Per-block receipt flags for a multicast transfer,
+     * indexed by block number (RFC 2090). */
+    std::vector<std::uint64_t> blockmap;
+    /** @brief The final multicast block number, or 0 until the short
+     * block arrives (RFC 2090). */
+    std::uint16_t mc_final = 0;
+    /** @brief Whether the transfer runs over a multicast group, where
+     * blocks arrive in any order (RFC 2090). */
+    bool multicast = false;
+    /** @brief Whether this client was elected master and acknowledges
+     * the server (RFC 2090). */
+    bool mc_master = false;
+
+    /**
+     * @brief Whether a multicast block has been received (RFC 2090).
+     * @param block The protocol block number.
+     * @returns `true` if the block's receipt flag is set.
+     */
+    [[nodiscard]] auto block_received(std::uint16_t block) const noexcept
+        -> bool
+    {
+      const auto word = block / 64U;
+      return word < blockmap.size() &&
+             (blockmap[word] >> (block % 64U) & 1U) != 0;
+    }
+
+    /**
+     * @brief Marks a multicast block received (RFC 2090).
+     * @details Advances block_num over the contiguous prefix of
+     * received blocks: a master client acknowledges the highest block
+     * below the first gap.
+     * @param block The protocol block number.
+     */
+    auto mark_block(std::uint16_t block) -> void
+    {
+      const auto word = block / 64U;
+      if (word >= blockmap.size())
+        blockmap.resize(word + 1);
+      blockmap[word] |= 1ULL << (block % 64U);
+
+      while (block_received(static_cast<std::uint16_t>(block_num + 1)))
+        ++block_num;
+    }
+
+    /**
+     * @brief Runs the deferred read-stage advance.
+     * @details `send_next()` leaves the cursor on the block it adopted
+     * and defers the advance; running it once the frame has been
+     * handed to the socket lets the successor's disk read (and any
+     * NETASCII expansion) overlap the adopted block's round trip
+     * instead of sitting between the ack and the send. Idempotent:
+     * the advance runs at most once per adopted block.
+     */
+    auto advance_read() -> void
+    {
+      if (!advance_pending)
+        return;
+
+      advance_pending = false;
+      if (chunk != std::default_sentinel)
+        ++chunk;
+    }
+
+    /**
+     * @brief Whether the session's read source is still open.
+     * @returns `true` while there is a file mapping or an open fstream.
+     */
+    [[nodiscard]] auto read_open() const noexcept -> bool
+    {
+      return map != nullptr || (file && file->is_open());
+    }
+
+    /**
+     * @brief Whether more DATA blocks remain to be produced.
+     * @details A transfer only completes once a short final block has
+     * been sent; the chunk source yields that block (empty if the file
+     * length is an exact multiple of the block size) before finishing,
+     * so a live cursor means another block is still due.
+     * @returns `true` if another DATA block should be built.
+     */
+    [[nodiscard]] auto read_pending() const noexcept -> bool
+    {
+      // A block prepared ahead of its acknowledgement is always due.
+      if (chunk != std::default_sentinel)
+        return true;
+
+      if (map)
+        return !map_eof;
+
+      // An exhausted (or never started) source restarts from the file
+      // position, so a block is still due until the read hits the end.
+      return file && file->is_open() && !file->eof();
+    }
+
+    /**
+     * @brief Stages an inbound payload for a coalesced write.
+     * @details Per-block fstream writes sit disk latency inside the
+     * packet-processing path; staged payloads are written out in
+     * WRITEBACK_MAX-sized batches instead.
+     * @param payload The payload bytes to stage.
+     */
+    auto stage_write(std::span<const char> payload) -> void
+    {
+      if (writeback.capacity() == 0)
+        writeback.reserve(WRITEBACK_MAX + blksize);
+
+      writeback.insert(writeback.end(), payload.begin(), payload.end());
+    }
+
+    /**
+     * @brief Writes the staged payloads out in a single write.
+     * @returns `false` if the underlying write failed.
+     */
+    [[nodiscard]] auto flush_writeback() -> bool
+    {
+      if (!writeback.empty())
+      {
+        file->write(writeback.data(),
+                    static_cast<std::streamsize>(writeback.size()));
+        writeback.clear();
+      }
+
+      return !file->fail();
+    }
   };
 
   /**
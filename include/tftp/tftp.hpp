@@ -20,18 +20,24 @@
 #pragma once
 #ifndef TFTP_HPP
 #define TFTP_HPP
+#include "detail/buffer_pool.hpp"
+#include "detail/pace_bucket.hpp"
+#include "detail/retry_timer.hpp"
+#include "detail/trace_ring.hpp"
+#include "detail/session_table.hpp"
 #include "protocol/tftp_protocol.hpp"
 #include "protocol/tftp_session.hpp"
 
 #include <net/cppnet.hpp>
 
-#include <map>
+#include <atomic>
+#include <deque>
+#include <functional>
 #include <netdb.h>
 /** @namespace For top-level tftp services. */
 namespace tftp {
 /** @brief The TFTP sessions container. */
-using sessions_t =
-    std::multimap<io::socket::socket_address<sockaddr_in6>, session_t>;
+using sessions_t = detail::session_table;
 /** @brief The TFTP sessions iterator. */
 using iterator_t = sessions_t::iterator;
 
@@ -80,6 +86,29 @@ struct client_sender {
    * an error code of 0 AND an empty string indicates an OK response.
    */
   using status_t = std::pair<std::uint16_t, std::string>;
+  /**
+   * @brief A sink for completed-transfer statistics.
+   * @details The sink is invoked from the session's context thread
+   * once per transfer, just before the completion value is delivered,
+   * and must not block.
+   */
+  using metrics_sink_t =
+      std::function<void(const session_t::state_t::statistics_t &)>;
+  /**
+   * @brief A polled snapshot of an in-flight transfer.
+   * @details The transfer's context thread publishes monotonic
+   * counters with relaxed stores as acks and data arrive; any other
+   * thread may poll them without synchronisation. A current rate
+   * derives from the byte delta between two polls.
+   */
+  struct progress_t {
+    /** @brief The octets moved on the wire, headers included. */
+    std::atomic<std::uint64_t> bytes{0};
+    /** @brief The DATA blocks acknowledged or accepted. */
+    std::atomic<std::uint64_t> blocks{0};
+    /** @brief The DATA blocks retransmitted. */
+    std::atomic<std::uint64_t> retransmits{0};
+  };
   /** @brief sender concept. */
   using sender_concept = stdexec::sender_t;
   /** @brief completion signature set value types. */
@@ -89,12 +118,14 @@ struct client_sender {
 
   /** @brief common elements for all tftp client operation states. */
   template <typename Receiver> struct client_state {
-    /** @brief The receive buffer. */
-    std::array<char, messages::DATAMSG_MAXLEN> recv_buffer{};
+    /** @brief The receive buffer, sized to the negotiated block. */
+    std::vector<char> recv_buffer = std::vector<char>(messages::DATAMSG_MAXLEN);
     /** @brief The tftp client session details */
     session_t session;
     /** @brief The socket message type. */
     socket_message sockmsg;
+    /** @brief The server's pinned transfer TID (RFC 1350). */
+    socket_address<sockaddr_in6> peer;
     /** @brief The local file path. */
     std::filesystem::path local;
     /** @brief The client socket. */
@@ -103,8 +134,68 @@ struct client_sender {
     Receiver receiver;
     /** @brief The asynchronous context. */
     async_context *ctx = nullptr;
+    /** @brief The buffer pool that session buffers are recycled to. */
+    detail::buffer_pool *pool = nullptr;
+    /** @brief Sink that receives the session statistics on completion. */
+    metrics_sink_t *metrics = nullptr;
+    /** @brief Snapshot the transfer publishes its progress into. */
+    progress_t *progress = nullptr;
+    /** @brief Outbound frames awaiting submission, oldest first. */
+    std::deque<std::vector<char>> outbox;
+    /** @brief The retry deadline for the in-flight request. */
+    detail::retry_timer retry;
+    /** @brief The token bucket pacing the outbox drain. */
+    detail::pace_bucket pace;
+    /** @brief The hot-path flight recorder (a stub unless built with
+     * TFTP_ENABLE_TRACE). */
+    detail::trace_ring trace;
     /** @brief completion state prevents duplicate calls to finalize. */
     bool finalized = false;
+    /** @brief options were requested and no OACK has arrived yet. */
+    bool options_pending = false;
+    /** @brief Whether an outbox drain is in flight. */
+    bool sending = false;
+    /** @brief Whether the server's transfer TID has been pinned. */
+    bool peer_pinned = false;
+
+    /**
+     * @brief Falls back to the protocol defaults when the first
+     * non-OACK response arrives for a request that carried options.
+     */
+    auto options_fallback() noexcept -> void;
+
+    /**
+     * @brief Pins the server's transfer TID and filters foreign sources.
+     * @details The request goes to the server's well-known port, but
+     * the transfer continues against the ephemeral socket that answers
+     * (RFC 1350). The first reply pins that source as the session
+     * peer; a datagram from any other source restores the send
+     * destination and is reported foreign, so a stray or hostile
+     * datagram can neither be processed nor redirect the transfer.
+     * @returns `true` if the datagram came from the session peer.
+     */
+    auto filter_peer() noexcept -> bool;
+
+    /**
+     * @brief Queues a frame for transmission.
+     * @details Frames are copied into the outbox so they stay alive
+     * for the duration of the asynchronous send; the copies draw on
+     * the buffer pool and return to it once submitted, so a long
+     * transfer reuses the same storage instead of paying the
+     * allocator per block. Queued frames are not submitted until the
+     * outbox is flushed.
+     * @param buf The frame to queue.
+     */
+    auto enqueue_sendmsg(const std::vector<char> &buf) noexcept -> void;
+
+    /**
+     * @brief Flushes the outbox.
+     * @details Spawns a drain that submits every queued frame back to
+     * back. At most one drain is in flight at a time, so a burst of
+     * frames coalesces into a single submission chain instead of one
+     * spawned send per packet.
+     */
+    auto flush_sendmsg() noexcept -> void;
 
     /**
      * @brief handle error messages
@@ -116,6 +207,24 @@ struct client_sender {
     /** @brief cleanup any lingering session state. */
     auto cleanup() noexcept -> void;
 
+    /** @brief Passes the session statistics to the registered sink. */
+    auto notify_metrics() noexcept -> void;
+
+    /**
+     * @brief Formats the recorded trace events out through the logger.
+     * @details Runs automatically when a transfer finalizes with an
+     * error and may be called on demand; the whole body compiles away
+     * with the trace ring.
+     */
+    auto dump_trace() noexcept -> void;
+
+    /**
+     * @brief Publishes the session statistics to the progress snapshot.
+     * @details Relaxed stores of monotonic counters: cheap enough for
+     * the per-ack path and safe to poll from any thread.
+     */
+    auto publish_progress() noexcept -> void;
+
     /**
      * @brief Finalize the client session with a tftp status code.
      * @param status The status message to finalize with. (default: OK)
@@ -138,8 +247,24 @@ struct client_sender {
   std::filesystem::path remote;
   /** @brief The asynchronous context. */
   async_context *ctx = nullptr;
+  /** @brief The buffer pool to draw session buffers from. */
+  detail::buffer_pool *pool = nullptr;
+  /** @brief Sink that receives the session statistics on completion. */
+  metrics_sink_t *metrics = nullptr;
+  /** @brief Snapshot the transfer publishes its progress into. */
+  progress_t *progress = nullptr;
   /** @brief The tftp transmission mode. */
   std::uint8_t mode = 0;
+  /** @brief The requested data block size (RFC 2348). */
+  std::uint16_t blksize = messages::DATALEN;
+  /** @brief The requested window size (RFC 7440). */
+  std::uint16_t windowsize = messages::WINDOWSIZE_MIN;
+  /** @brief The requested timeout in seconds, or 0 to leave the
+   * retransmission estimator to its defaults (RFC 2349). */
+  std::uint8_t timeout = 0;
+  /** @brief The outbound pacing ceiling in bytes per second, or 0 for
+   * unpaced sends. */
+  std::uint64_t rate = 0;
 };
 
 /** @brief The sender for an asynchronous connect. */
@@ -160,6 +285,13 @@ struct connect_t {
     /** @brief Initiate the asynchronous connect. */
     auto start() noexcept -> void;
 
+    /**
+     * @brief Resolve the hostname and complete through the receiver.
+     * @details Runs off the caller's thread: getaddrinfo blocks.
+     * @param key The "hostname:port" cache key for the resolved address.
+     */
+    auto resolve(const std::string &key) noexcept -> void;
+
     /** @brief hostname to connect to. */
     std::string hostname;
     /** @brief port to connect to. */
@@ -190,6 +322,10 @@ struct put_file_t : client_sender {
       stdexec::completion_signatures<set_value_t(status_t),
                                      set_error_t(std::error_code)>;
 
+  /** @brief Duplicate acks that trigger a fast retransmit (cf. RFC
+   * 5681); fewer may be stray duplication rather than loss. */
+  static constexpr auto DUP_ACK_LIMIT = 3;
+
   /** @brief sender operation state. */
   template <typename Receiver> struct state_t : client_state<Receiver> {
     /** @brief Initiate the asynchronous put. */
@@ -204,7 +340,35 @@ struct put_file_t : client_sender {
      */
     auto ack_handler(messages::ack ack) noexcept -> void;
 
-    /** @brief Submit an asynchronous sendmsg to the context. */
+    /**
+     * @brief OACK handler (RFC 2347).
+     * @param msg The OACK message.
+     * @param len The length of the OACK message.
+     */
+    auto oack_handler(const char *msg, std::streamsize len) noexcept -> void;
+
+    /**
+     * @brief Windowed ack handler (RFC 7440).
+     * @details Slides the transmission window forward on in-window
+     * acks, and retransmits the whole window (go-back-N) on stale or
+     * duplicate acks.
+     * @param ack The ack message.
+     */
+    auto window_ack_handler(messages::ack ack) noexcept -> void;
+
+    /**
+     * @brief Fills the transmission window with pending DATA blocks.
+     * @returns 0 if successful, a non-zero TFTP error otherwise.
+     */
+    auto fill_window() -> std::uint16_t;
+
+    /** @brief Retransmits every in-flight DATA block (go-back-N). */
+    auto retransmit_window() noexcept -> void;
+
+    /** @brief Returns the window's frames to the buffer pool. */
+    auto recycle_window() noexcept -> void;
+
+    /** @brief Queue the session buffer in the outbox and flush it. */
     auto submit_sendmsg() noexcept -> void;
 
     /** @brief Submit async recvmsg to the context. */
@@ -216,6 +380,11 @@ struct put_file_t : client_sender {
      * @param len The length of the received message.
      */
     auto route_message(const char *msg, std::streamsize len) noexcept -> void;
+
+    /** @brief In-flight DATA blocks, oldest unacked block first. */
+    std::deque<std::vector<char>> window;
+    /** @brief Consecutive duplicate acks for the last in-order block. */
+    std::uint16_t dup_acks = 0;
   };
 
   /**
@@ -250,6 +419,13 @@ struct get_file_t : client_sender {
      */
     auto data_handler(const char *msg, std::streamsize len) noexcept -> void;
 
+    /**
+     * @brief OACK handler (RFC 2347).
+     * @param msg The OACK message.
+     * @param len The length of the OACK message.
+     */
+    auto oack_handler(const char *msg, std::streamsize len) noexcept -> void;
+
     /** @brief Submit an asynchronous sendmsg to the context. */
     auto submit_sendmsg() noexcept -> void;
 
@@ -262,6 +438,12 @@ struct get_file_t : client_sender {
      * @param len The length of the received message.
      */
     auto route_message(const char *msg, std::streamsize len) noexcept -> void;
+
+    /** @brief Accepted blocks since the last ack (RFC 7440). */
+    std::uint16_t unacked = 0;
+    /** @brief An out-of-order ack has been sent for the current gap;
+     * cleared when the window advances (RFC 7440). */
+    bool gap_acked = false;
   };
 
   /**
@@ -272,6 +454,11 @@ struct get_file_t : client_sender {
    */
   template <typename Receiver>
   auto connect(Receiver &&receiver) -> state_t<Receiver>;
+
+  /** @brief Whether to request a multicast transfer (RFC 2090). Only
+   * octet blocks land at a fixed file offset, so other modes stay
+   * unicast. */
+  bool multicast = false;
 };
 
 } // namespace client.
@@ -20,7 +20,12 @@
 #pragma once
 #ifndef TFTP_CLIENT_HPP
 #define TFTP_CLIENT_HPP
+#include "detail/buffer_pool.hpp"
 #include "tftp.hpp"
+
+#include <atomic>
+#include <memory>
+#include <vector>
 /** @namespace For top-level tftp services. */
 namespace tftp {
 /** @brief The service type to use. */
@@ -41,6 +46,10 @@ public:
   struct client_t {
     /** @brief asynchronous context pointer. */
     async_context *ctx = nullptr;
+    /** @brief The manager's buffer pool. */
+    detail::buffer_pool *pool = nullptr;
+    /** @brief The manager's metrics sink. */
+    client::client_sender::metrics_sink_t *metrics = nullptr;
 
     /**
      * @brief connect the client to a TFTP server.
@@ -58,12 +67,25 @@ public:
      * @param local the local file to send.
      * @param remote the remote path to write to.
      * @param mode the tftp transmission mode (default: netascii)
+     * @param blksize the data block size to negotiate (default: 512)
+     * @param windowsize the window size to negotiate (default: 1)
+     * @param timeout the timeout in seconds to negotiate (default: 0, none)
+     * @param progress optional snapshot the transfer publishes its
+     * progress into; must outlive the operation (default: none)
+     * @param rate the outbound pacing ceiling in bytes per second
+     * (default: 0, unpaced)
      * @returns A sender for the put file operation.
      */
     [[nodiscard]] auto put(io::socket::socket_address<sockaddr_in6> server_addr,
                            std::string local, std::string remote,
-                           std::uint8_t mode = messages::NETASCII)
-        const noexcept -> client::put_file_t;
+                           std::uint8_t mode = messages::NETASCII,
+                           std::uint16_t blksize = messages::DATALEN,
+                           std::uint16_t windowsize = messages::WINDOWSIZE_MIN,
+                           std::uint8_t timeout = 0,
+                           client::client_sender::progress_t *progress =
+                               nullptr,
+                           std::uint64_t rate = 0) const noexcept
+        -> client::put_file_t;
 
     /**
      * @brief get a file from the tftp server.
@@ -71,22 +93,76 @@ public:
      * @param remote the remote path to read from.
      * @param local the local path to write to.
      * @param mode the tftp transmission mode (default: netascii)
+     * @param blksize the data block size to negotiate (default: 512)
+     * @param windowsize the window size to negotiate (default: 1)
+     * @param timeout the timeout in seconds to negotiate (default: 0, none)
+     * @param progress optional snapshot the transfer publishes its
+     * progress into; must outlive the operation (default: none)
+     * @param rate the outbound pacing ceiling in bytes per second
+     * (default: 0, unpaced)
+     * @param multicast whether to request a multicast transfer; octet
+     * mode only (default: false) (RFC 2090)
      * @returns A sender for the put file operation.
      */
     [[nodiscard]] auto get(io::socket::socket_address<sockaddr_in6> server_addr,
                            std::string remote, std::string local,
-                           std::uint8_t mode = messages::NETASCII)
-        const noexcept -> client::get_file_t;
+                           std::uint8_t mode = messages::NETASCII,
+                           std::uint16_t blksize = messages::DATALEN,
+                           std::uint16_t windowsize = messages::WINDOWSIZE_MIN,
+                           std::uint8_t timeout = 0,
+                           client::client_sender::progress_t *progress =
+                               nullptr,
+                           std::uint64_t rate = 0,
+                           bool multicast = false) const noexcept
+        -> client::get_file_t;
   };
 
+  /**
+   * @brief Constructs a client manager.
+   * @details With more than one context, transfers handed out by
+   * make_client() are distributed round-robin across a pool of
+   * context threads, each with its own poller and timer queue, so
+   * concurrent transfers scale across cores without shared locks.
+   * @param contexts The number of context threads to pool (default: 1).
+   */
+  explicit client_manager(std::size_t contexts = 1);
+
   /**
    * @brief client factory.
+   * @details Each returned client is bound to the next context in the
+   * pool; contexts are started lazily on first use.
    * @returns A TFTP client.
    */
   auto make_client() -> client_t;
 
+  /**
+   * @brief The number of pooled context threads.
+   * @returns The context pool size.
+   */
+  [[nodiscard]] auto contexts() const noexcept -> std::size_t
+  {
+    return ctxs_.size();
+  }
+
+  /**
+   * @brief Registers a sink for completed-transfer statistics.
+   * @details The sink is shared by every client this manager hands
+   * out and is invoked once per transfer from the transfer's context
+   * thread. Register the sink before starting any transfers.
+   * @param sink The sink to register.
+   */
+  auto set_metrics_sink(client::client_sender::metrics_sink_t sink) -> void
+  {
+    metrics_ = std::move(sink);
+  }
+
 private:
-  context_thread ctx_;
+  std::vector<std::unique_ptr<context_thread>> ctxs_;
+  std::atomic<std::size_t> next_{0};
+  /** @brief Recycled message buffers, shared by every context. */
+  detail::buffer_pool pool_;
+  /** @brief Completed-transfer statistics sink, shared by every client. */
+  client::client_sender::metrics_sink_t metrics_;
 };
 } // namespace tftp
 #endif // TFTP_CLIENT_HPP
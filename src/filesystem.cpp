@@ -22,7 +22,18 @@
 #include <cstdio>
 #include <format>
 #include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 namespace tftp::filesystem {
+file_map::~file_map()
+{
+  if (addr_)
+    (void)::munmap(addr_, size_);
+}
+
 auto count() noexcept -> std::atomic<std::uint16_t> &
 {
   static auto count = std::atomic<std::uint16_t>(0);
@@ -61,6 +72,13 @@ auto tmpname() -> std::filesystem::path
       .concat(std::format("{:05d}", count()++));
 }
 
+auto tmpname(const std::filesystem::path &target) -> std::filesystem::path
+{
+  auto name = std::format(".{}.{}{:05d}", target.filename().string(), prefix,
+                          count()++);
+  return target.parent_path() / name;
+}
+
 // NOLINTBEGIN(cppcoreguidelines-owning-memory)
 auto touch(const std::filesystem::path &file) -> std::error_code
 {
@@ -94,6 +112,44 @@ auto open_read(const std::filesystem::path &file,
   return fstream;
 }
 
+auto open_map(const std::filesystem::path &file,
+              std::error_code &err) -> std::shared_ptr<file_map>
+{
+  err.clear();
+  auto fd = ::open(file.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+  {
+    err = {errno, std::system_category()};
+    return {};
+  }
+
+  struct stat st{};
+  if (::fstat(fd, &st) < 0)
+  {
+    err = {errno, std::system_category()}; // GCOVR_EXCL_LINE
+    (void)::close(fd);                     // GCOVR_EXCL_LINE
+    return {};                             // GCOVR_EXCL_LINE
+  }
+
+  auto size = static_cast<std::size_t>(st.st_size);
+  if (size == 0)
+  {
+    (void)::close(fd);
+    return std::make_shared<file_map>(nullptr, 0);
+  }
+
+  auto *addr = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  (void)::close(fd);
+  if (addr == MAP_FAILED)
+  {
+    err = {errno, std::system_category()}; // GCOVR_EXCL_LINE
+    return {};                             // GCOVR_EXCL_LINE
+  }
+
+  (void)::madvise(addr, size, MADV_SEQUENTIAL);
+  return std::make_shared<file_map>(addr, size);
+}
+
 auto open_write(const std::filesystem::path &file, std::filesystem::path &tmp,
                 std::error_code &err) -> std::shared_ptr<std::fstream>
 {
@@ -102,7 +158,7 @@ auto open_write(const std::filesystem::path &file, std::filesystem::path &tmp,
   if (err)
     return {};
 
-  tmp = tmpname();
+  tmp = tmpname(file);
   auto fstream = std::make_shared<std::fstream>(
       tmp, std::ios::out | std::ios::trunc | std::ios::binary);
   if (!fstream->is_open())
@@ -16,16 +16,32 @@
 #include "tftp/detail/argument_parser.hpp"
 #include "tftp/tftp_client.hpp"
 
+#include <exec/async_scope.hpp>
+
 #include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
 #include <csignal>
 #include <cstdlib>
+#include <deque>
+#include <fstream>
 #include <iostream>
+#include <mutex>
+#include <optional>
+#include <semaphore>
+#include <sstream>
 #include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 using namespace net::service;
 using namespace tftp;
 
 static constexpr std::string PORT = "69";
+/** @brief The index file a recursive get fetches from the remote tree. */
+static constexpr std::string REMOTE_MANIFEST = "MANIFEST";
 
 struct config {
   /** @brief tftp method enum. */
@@ -42,6 +58,34 @@ struct config {
   method_t method;
   /** @brief tftp operation mode. */
   messages::mode_t mode;
+  /** @brief tftp data block size (RFC 2348). */
+  std::uint16_t blksize = messages::DATALEN;
+  /** @brief tftp window size (RFC 7440). */
+  std::uint16_t windowsize = messages::WINDOWSIZE_MIN;
+  /** @brief tftp timeout in seconds, 0 when not negotiated (RFC 2349). */
+  std::uint8_t timeout = 0;
+  /** @brief outbound pacing ceiling in bytes per second, 0 unpaced. */
+  std::uint64_t rate = 0;
+  /** @brief report transfer progress on stderr. */
+  bool progress = false;
+  /** @brief transfer a directory tree instead of a single file. */
+  bool recursive = false;
+  /** @brief server replicas; manifest operations round-robin across them. */
+  std::vector<std::pair<std::string, std::string>> replicas;
+  /** @brief manifest file listing a batch of tftp operations. */
+  std::filesystem::path manifest;
+  /** @brief maximum number of concurrent manifest transfers. */
+  std::size_t jobs = 4;
+};
+
+/** @brief A single get/put operation parsed from a manifest. */
+struct manifest_op {
+  /** @brief tftp method. */
+  config::method_t method;
+  /** @brief local path for the operation. */
+  std::filesystem::path local;
+  /** @brief remote path for the operation. */
+  std::filesystem::path remote;
 };
 
 static auto print_usage(const char *program_name) -> void
@@ -49,14 +93,36 @@ static auto print_usage(const char *program_name) -> void
   std::cerr
       << "Usage: " << program_name << " [OPTIONS] get <remote> <local>\n"
       << "       " << program_name << " [OPTIONS] put <local> <remote>\n"
+      << "       " << program_name << " [OPTIONS] -r get <remotedir> <localdir>\n"
+      << "       " << program_name << " [OPTIONS] -r put <localdir> <remotedir>\n"
+      << "       " << program_name << " [OPTIONS] -f <manifest>\n"
       << "Arguments:\n"
       << "  get <remote> <local>    Download remote file to local path\n"
       << "  put <local> <remote>    Upload local file to remote path\n"
       << "\nOptions:\n"
       << "  -h, --help              Display this help message\n"
       << "  -H, --host=<host[:port]> TFTP server hostname:port "
-         "(required, default port: 69)\n"
-      << "  --mode=<netascii|octet|mail> Transfer mode (default: octet)\n";
+         "(required, default port: 69).\n"
+         "                          May be repeated; manifest transfers\n"
+         "                          are distributed across the replicas\n"
+      << "  --mode=<netascii|octet|mail> Transfer mode (default: octet)\n"
+      << "  --blksize=<8-65464>     Negotiated block size (default: 512)\n"
+      << "  --windowsize=<1-65535>  Negotiated window size (default: 1)\n"
+      << "  --timeout=<1-255>       Negotiated timeout in seconds "
+         "(default: none)\n"
+      << "  --rate=<bytes/sec>      Pace outbound data at a ceiling rate\n"
+         "                          (default: unpaced)\n"
+      << "  --progress              Report transfer progress on stderr;\n"
+         "                          batches report aggregate totals\n"
+      << "  -r, --recursive         Transfer a directory tree. TFTP cannot\n"
+         "                          list directories, so a recursive get\n"
+         "                          fetches <remotedir>/MANIFEST (one\n"
+         "                          relative path per line) first\n"
+      << "  -f, --file=<manifest>   Run a batch of get/put operations, one\n"
+         "                          per line: 'get <remote> <local>' or\n"
+         "                          'put <local> <remote>'\n"
+      << "  -j, --jobs=<N>          Concurrent batch transfers "
+         "(default: 4)\n";
 }
 
 static auto to_lowercase(std::string_view input) -> std::string
@@ -130,8 +196,10 @@ static auto handle_option(const tftp::detail::argument_parser::option &opt,
       std::cerr << "Error: --host requires a value\n";
       return false;
     }
+    conf.port = PORT;
     if (!parse_host_port(opt.value, conf.hostname, conf.port))
       return false;
+    conf.replicas.emplace_back(conf.hostname, conf.port);
     has_hostname = true;
     return true;
   }
@@ -154,6 +222,136 @@ static auto handle_option(const tftp::detail::argument_parser::option &opt,
     return true;
   }
 
+  if (opt.flag == "--blksize")
+  {
+    if (opt.value.empty())
+    {
+      std::cerr << "Error: --blksize requires a value\n";
+      return false;
+    }
+
+    auto blksize = 0UL;
+    auto [ptr, err] = std::from_chars(
+        opt.value.data(), opt.value.data() + opt.value.size(), blksize);
+    if (err != std::errc() || ptr != opt.value.data() + opt.value.size() ||
+        blksize < messages::BLKSIZE_MIN || blksize > messages::BLKSIZE_MAX)
+    {
+      std::cerr << "Error: --blksize must be between 8 and 65464\n";
+      return false;
+    }
+    conf.blksize = static_cast<std::uint16_t>(blksize);
+    return true;
+  }
+
+  if (opt.flag == "--windowsize")
+  {
+    if (opt.value.empty())
+    {
+      std::cerr << "Error: --windowsize requires a value\n";
+      return false;
+    }
+
+    auto windowsize = 0UL;
+    auto [ptr, err] = std::from_chars(
+        opt.value.data(), opt.value.data() + opt.value.size(), windowsize);
+    if (err != std::errc() || ptr != opt.value.data() + opt.value.size() ||
+        windowsize < messages::WINDOWSIZE_MIN ||
+        windowsize > messages::WINDOWSIZE_MAX)
+    {
+      std::cerr << "Error: --windowsize must be between 1 and 65535\n";
+      return false;
+    }
+    conf.windowsize = static_cast<std::uint16_t>(windowsize);
+    return true;
+  }
+
+  if (opt.flag == "--timeout")
+  {
+    if (opt.value.empty())
+    {
+      std::cerr << "Error: --timeout requires a value\n";
+      return false;
+    }
+
+    auto timeout = 0UL;
+    auto [ptr, err] = std::from_chars(
+        opt.value.data(), opt.value.data() + opt.value.size(), timeout);
+    if (err != std::errc() || ptr != opt.value.data() + opt.value.size() ||
+        timeout < messages::TIMEOUT_OPT_MIN ||
+        timeout > messages::TIMEOUT_OPT_MAX)
+    {
+      std::cerr << "Error: --timeout must be between 1 and 255\n";
+      return false;
+    }
+    conf.timeout = static_cast<std::uint8_t>(timeout);
+    return true;
+  }
+
+  if (opt.flag == "--rate")
+  {
+    if (opt.value.empty())
+    {
+      std::cerr << "Error: --rate requires a value\n";
+      return false;
+    }
+
+    auto rate = std::uint64_t{};
+    auto [ptr, err] = std::from_chars(
+        opt.value.data(), opt.value.data() + opt.value.size(), rate);
+    if (err != std::errc() || ptr != opt.value.data() + opt.value.size() ||
+        rate == 0)
+    {
+      std::cerr << "Error: --rate must be a positive integer\n";
+      return false;
+    }
+    conf.rate = rate;
+    return true;
+  }
+
+  if (opt.flag == "--progress")
+  {
+    conf.progress = true;
+    return true;
+  }
+
+  if (opt.flag == "-r" || opt.flag == "--recursive")
+  {
+    conf.recursive = true;
+    return true;
+  }
+
+  if (opt.flag == "-f" || opt.flag == "--file")
+  {
+    if (opt.value.empty())
+    {
+      std::cerr << "Error: --file requires a value\n";
+      return false;
+    }
+    conf.manifest = opt.value;
+    return true;
+  }
+
+  if (opt.flag == "-j" || opt.flag == "--jobs")
+  {
+    if (opt.value.empty())
+    {
+      std::cerr << "Error: --jobs requires a value\n";
+      return false;
+    }
+
+    auto jobs = 0UL;
+    auto [ptr, err] = std::from_chars(
+        opt.value.data(), opt.value.data() + opt.value.size(), jobs);
+    if (err != std::errc() || ptr != opt.value.data() + opt.value.size() ||
+        jobs == 0)
+    {
+      std::cerr << "Error: --jobs must be a positive integer\n";
+      return false;
+    }
+    conf.jobs = jobs;
+    return true;
+  }
+
   if (!opt.flag.empty())
   {
     std::cerr << "Error: Unknown option: " << opt.flag << "\n";
@@ -238,6 +436,24 @@ static auto parse_arguments(int argc, char *argv[]) -> std::optional<config>
     }
   }
 
+  if (!conf.manifest.empty())
+  {
+    if (conf.recursive)
+    {
+      std::cerr << "Error: --file and --recursive are mutually exclusive\n";
+      return std::nullopt;
+    }
+
+    if (!has_hostname)
+    {
+      std::cerr << "Error: Missing required --host option\n";
+      print_usage(program_name);
+      return std::nullopt;
+    }
+
+    return conf;
+  }
+
   if (positional_count < 3)
   {
     std::cerr << "Error: Missing required positional arguments\n";
@@ -259,6 +475,392 @@ static auto parse_arguments(int argc, char *argv[]) -> std::optional<config>
   return conf;
 }
 
+static auto parse_manifest(const config &conf)
+    -> std::optional<std::vector<manifest_op>>
+{
+  auto manifest = std::ifstream(conf.manifest);
+  if (!manifest.is_open())
+  {
+    std::cerr << "Error: Cannot open manifest: " << conf.manifest << "\n";
+    return std::nullopt;
+  }
+
+  auto ops = std::vector<manifest_op>{};
+  auto line = std::string{};
+  for (std::size_t lineno = 1; std::getline(manifest, line); ++lineno)
+  {
+    if (line.empty() || line.front() == '#')
+      continue;
+
+    auto stream = std::istringstream(line);
+    std::string method_str;
+    std::string first_arg;
+    std::string second_arg;
+    if (!(stream >> method_str >> first_arg >> second_arg))
+    {
+      std::cerr << "Error: Malformed manifest line " << lineno << ": " << line
+                << "\n";
+      return std::nullopt;
+    }
+
+    auto method = parse_method(method_str);
+    if (!method)
+    {
+      std::cerr << "Error: method must be 'get' or 'put' on manifest line "
+                << lineno << "\n";
+      return std::nullopt;
+    }
+
+    if (*method == config::GET && conf.mode == messages::MAIL)
+    {
+      std::cerr << "Error: Mail mode is not allowed in read requests "
+                   "(manifest line "
+                << lineno << ")\n";
+      return std::nullopt;
+    }
+
+    if (*method == config::GET)
+      ops.push_back({.method = *method, .local = second_arg,
+                     .remote = first_arg});
+    else
+      ops.push_back({.method = *method, .local = first_arg,
+                     .remote = second_arg});
+  }
+
+  return ops;
+}
+
+/**
+ * @brief Reports transfer progress snapshots on stderr.
+ * @details A background thread samples the snapshots twice a second and
+ * rewrites a single status line with their aggregate; the rate is the
+ * byte delta between consecutive samples. The destructor prints a final
+ * sample so short transfers still report their totals.
+ */
+class progress_reporter {
+public:
+  /** @brief One snapshot per transfer; a deque keeps their addresses
+   * stable while the counters are live. */
+  using snapshots_t = std::deque<client::client_sender::progress_t>;
+
+  explicit progress_reporter(const snapshots_t &progress)
+      : progress_(progress), thread_([this] { run(); })
+  {
+  }
+
+  progress_reporter(const progress_reporter &) = delete;
+  progress_reporter(progress_reporter &&) = delete;
+  auto operator=(const progress_reporter &) -> progress_reporter & = delete;
+  auto operator=(progress_reporter &&) -> progress_reporter & = delete;
+
+  ~progress_reporter()
+  {
+    done_ = true;
+    thread_.join();
+    report();
+    std::cerr << "\n";
+  }
+
+private:
+  auto run() -> void
+  {
+    while (!done_)
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(500));
+      report();
+    }
+  }
+
+  auto report() -> void
+  {
+    using namespace std::chrono;
+    constexpr auto MIB = 1024.0 * 1024.0;
+
+    auto bytes = std::uint64_t{};
+    auto blocks = std::uint64_t{};
+    auto retransmits = std::uint64_t{};
+    for (const auto &snapshot : progress_)
+    {
+      bytes += snapshot.bytes.load(std::memory_order_relaxed);
+      blocks += snapshot.blocks.load(std::memory_order_relaxed);
+      retransmits += snapshot.retransmits.load(std::memory_order_relaxed);
+    }
+
+    const auto now = steady_clock::now();
+    const auto elapsed = duration_cast<duration<double>>(now - last_).count();
+    const auto rate = elapsed > 0 ? static_cast<double>(bytes - last_bytes_) /
+                                        elapsed
+                                  : 0.0;
+    last_ = now;
+    last_bytes_ = bytes;
+
+    std::cerr << std::format(
+        "\r{:.1f} MiB, {} blocks, {:.1f} MiB/s, {} retransmits",
+        static_cast<double>(bytes) / MIB, blocks, rate / MIB, retransmits);
+  }
+
+  const snapshots_t &progress_;
+  std::chrono::steady_clock::time_point last_ = std::chrono::steady_clock::now();
+  std::uint64_t last_bytes_ = 0;
+  std::atomic<bool> done_ = false;
+  std::thread thread_;
+};
+
+/**
+ * @brief Fans a batch of operations out across the manager's contexts.
+ * @details Transfers are striped across the resolved replicas with the
+ * concurrency bounded by --jobs; failures are reported as the transfers
+ * complete. With --progress the per-transfer snapshots are aggregated
+ * into one status line.
+ * @param conf The parsed command line configuration.
+ * @param ops The operations to run.
+ * @returns 0 when every transfer succeeded, 1 otherwise.
+ */
+static auto run_batch(const config &conf,
+                      const std::vector<manifest_op> &ops) -> int
+{
+  using namespace stdexec;
+  using status_t = client::client_sender::status_t;
+
+  auto contexts = std::min<std::size_t>(
+      conf.jobs, std::max(std::thread::hardware_concurrency(), 1U));
+  auto manager = client_manager(contexts);
+
+  // Resolve each replica once and stripe the batch across them; with a
+  // single --host this degenerates to the old reuse of one address.
+  auto resolve = manager.make_client();
+  auto server_addrs = std::vector<io::socket::socket_address<sockaddr_in6>>{};
+  try
+  {
+    for (const auto &[host, port] : conf.replicas)
+    {
+      auto [addr] = sync_wait(resolve.connect(host, port)).value();
+      server_addrs.push_back(addr);
+    }
+  }
+  catch (const std::exception &err)
+  {
+    std::cerr << "Error: " << err.what() << "\n";
+    return 1;
+  }
+
+  auto progress = progress_reporter::snapshots_t{};
+  auto reporter = std::optional<progress_reporter>{};
+  if (conf.progress)
+  {
+    for (std::size_t i = 0; i < ops.size(); ++i)
+      progress.emplace_back();
+    reporter.emplace(progress);
+  }
+
+  auto scope = exec::async_scope{};
+  auto slots = std::counting_semaphore<>{static_cast<std::ptrdiff_t>(conf.jobs)};
+  auto io_mutex = std::mutex{};
+  auto failures = std::atomic<int>{0};
+
+  auto next_replica = std::size_t{};
+  auto next_snapshot = std::size_t{};
+  for (const auto &op : ops)
+  {
+    slots.acquire();
+    auto client = manager.make_client();
+    auto server_addr = server_addrs[next_replica++ % server_addrs.size()];
+    auto *snapshot = conf.progress ? &progress[next_snapshot++] : nullptr;
+
+    auto report = [&, remote = op.remote](status_t status) noexcept {
+      auto &[error, message] = status;
+      if (error || !message.empty())
+      {
+        ++failures;
+        auto lock = std::lock_guard(io_mutex);
+        std::cerr << std::format("{}: {} {}\n", remote.string(), error,
+                                 message);
+      }
+      slots.release();
+    };
+
+    auto report_error = [&, remote = op.remote](std::error_code err) noexcept {
+      ++failures;
+      {
+        auto lock = std::lock_guard(io_mutex);
+        std::cerr << std::format("{}: {}\n", remote.string(), err.message());
+      }
+      slots.release();
+    };
+
+    if (op.method == config::GET)
+    {
+      scope.spawn(client.get(server_addr, op.remote, op.local, conf.mode,
+                             conf.blksize, conf.windowsize, conf.timeout,
+                             snapshot, conf.rate) |
+                  then(report) | upon_error(report_error));
+    }
+    else
+    {
+      scope.spawn(client.put(server_addr, op.local, op.remote, conf.mode,
+                             conf.blksize, conf.windowsize, conf.timeout,
+                             snapshot, conf.rate) |
+                  then(report) | upon_error(report_error));
+    }
+  }
+
+  sync_wait(scope.on_empty());
+  reporter.reset();
+  return failures ? 1 : 0;
+}
+
+static auto run_manifest(const config &conf) -> int
+{
+  auto ops = parse_manifest(conf);
+  if (!ops)
+    return 1;
+
+  return run_batch(conf, *ops);
+}
+
+/**
+ * @brief Expands a local directory tree into put operations.
+ * @details Every regular file below the local root is uploaded to the
+ * remote root under the same relative path.
+ * @param conf The parsed command line configuration.
+ * @returns The put operations, or nullopt if the walk failed.
+ */
+static auto expand_put_tree(const config &conf)
+    -> std::optional<std::vector<manifest_op>>
+{
+  auto err = std::error_code();
+  if (!std::filesystem::is_directory(conf.local, err))
+  {
+    std::cerr << "Error: Not a directory: " << conf.local << "\n";
+    return std::nullopt;
+  }
+
+  auto ops = std::vector<manifest_op>{};
+  try
+  {
+    for (const auto &entry :
+         std::filesystem::recursive_directory_iterator(conf.local))
+    {
+      if (!entry.is_regular_file())
+        continue;
+
+      auto relative = std::filesystem::relative(entry.path(), conf.local);
+      ops.push_back({.method = config::PUT, .local = entry.path(),
+                     .remote = conf.remote / relative});
+    }
+  }
+  catch (const std::exception &exc)
+  {
+    std::cerr << "Error: " << exc.what() << "\n";
+    return std::nullopt;
+  }
+
+  return ops;
+}
+
+/**
+ * @brief Expands a remote directory tree into get operations.
+ * @details TFTP has no directory listing, so the remote tree must
+ * describe itself: the index at `<remotedir>/MANIFEST` lists one
+ * relative path per line ('#' comments allowed). The index is fetched
+ * first, then each listed file is downloaded under the local root;
+ * absolute paths and paths that climb out of it are rejected.
+ * @param conf The parsed command line configuration.
+ * @returns The get operations, or nullopt if the index could not be
+ * fetched or parsed.
+ */
+static auto expand_get_tree(const config &conf)
+    -> std::optional<std::vector<manifest_op>>
+{
+  using namespace stdexec;
+
+  auto err = std::error_code();
+  std::filesystem::create_directories(conf.local, err);
+  if (err)
+  {
+    std::cerr << "Error: Cannot create " << conf.local << ": " << err.message()
+              << "\n";
+    return std::nullopt;
+  }
+
+  const auto remote_index = conf.remote / REMOTE_MANIFEST;
+  const auto index = conf.local / ".tftp-manifest";
+  try
+  {
+    auto manager = client_manager();
+    auto client = manager.make_client();
+    sender auto fetch =
+        client.connect(conf.hostname, conf.port) | let_value([&](auto addr) {
+          return client.get(addr, remote_index, index, messages::OCTET,
+                            conf.blksize, conf.windowsize, conf.timeout);
+        });
+
+    auto [status] = sync_wait(std::move(fetch)).value();
+    auto &[error, message] = status;
+    if (error || !message.empty())
+    {
+      std::cerr << std::format("{}: {} {}\n", remote_index.string(), error,
+                               message);
+      std::filesystem::remove(index, err);
+      return std::nullopt;
+    }
+  }
+  catch (const std::exception &exc)
+  {
+    std::cerr << "Error: " << exc.what() << "\n";
+    std::filesystem::remove(index, err);
+    return std::nullopt;
+  }
+
+  auto ops = std::optional<std::vector<manifest_op>>{std::in_place};
+  auto stream = std::ifstream(index);
+  auto line = std::string{};
+  for (std::size_t lineno = 1; ops && std::getline(stream, line); ++lineno)
+  {
+    if (line.empty() || line.front() == '#')
+      continue;
+
+    auto relative = std::filesystem::path(line).lexically_normal();
+    if (relative.is_absolute() || relative.begin()->string() == "..")
+    {
+      std::cerr << "Error: Unsafe path on index line " << lineno << ": "
+                << line << "\n";
+      ops.reset();
+      break;
+    }
+
+    std::filesystem::create_directories((conf.local / relative).parent_path(),
+                                        err);
+    ops->push_back({.method = config::GET, .local = conf.local / relative,
+                    .remote = conf.remote / relative});
+  }
+
+  stream.close();
+  std::filesystem::remove(index, err);
+  return ops;
+}
+
+/**
+ * @brief Runs a recursive directory transfer.
+ * @param conf The parsed command line configuration.
+ * @returns 0 when every transfer succeeded, 1 otherwise.
+ */
+static auto run_recursive(const config &conf) -> int
+{
+  if (conf.method == config::GET && conf.mode == messages::MAIL)
+  {
+    std::cerr << "Error: Mail mode is not allowed in read requests\n";
+    return 1;
+  }
+
+  auto ops = conf.method == config::PUT ? expand_put_tree(conf)
+                                        : expand_get_tree(conf);
+  if (!ops)
+    return 1;
+
+  return run_batch(conf, *ops);
+}
+
 static auto put_file(const config &conf,
                      const client_manager::client_t &client) -> void
 {
@@ -270,11 +872,21 @@ static auto put_file(const config &conf,
   const auto &remote = conf.remote;
   const auto &mode = conf.mode;
 
-  sender auto put_file = client.connect(host, port) | let_value([&](auto addr) {
-                           return client.put(addr, local, remote, mode);
-                         });
+  auto progress = progress_reporter::snapshots_t(1);
+  auto reporter = std::optional<progress_reporter>{};
+  if (conf.progress)
+    reporter.emplace(progress);
+
+  sender auto put_file =
+      client.connect(host, port) | let_value([&](auto addr) {
+        return client.put(addr, local, remote, mode, conf.blksize,
+                          conf.windowsize, conf.timeout,
+                          conf.progress ? &progress.front() : nullptr,
+                          conf.rate);
+      });
 
   auto [status] = sync_wait(std::move(put_file)).value();
+  reporter.reset();
 
   auto &[error, message] = status;
   if (error || !message.empty())
@@ -292,11 +904,21 @@ static auto get_file(const config &conf,
   const auto &remote = conf.remote;
   const auto &mode = conf.mode;
 
-  sender auto get_file = client.connect(host, port) | let_value([&](auto addr) {
-                           return client.get(addr, remote, local, mode);
-                         });
+  auto progress = progress_reporter::snapshots_t(1);
+  auto reporter = std::optional<progress_reporter>{};
+  if (conf.progress)
+    reporter.emplace(progress);
+
+  sender auto get_file =
+      client.connect(host, port) | let_value([&](auto addr) {
+        return client.get(addr, remote, local, mode, conf.blksize,
+                          conf.windowsize, conf.timeout,
+                          conf.progress ? &progress.front() : nullptr,
+                          conf.rate);
+      });
 
   auto [status] = sync_wait(std::move(get_file)).value();
+  reporter.reset();
 
   auto &[error, message] = status;
   if (error || !message.empty())
@@ -312,6 +934,12 @@ auto main(int argc, char *argv[]) -> int
     return 1;
 
   auto &conf = *opts;
+  if (!conf.manifest.empty())
+    return run_manifest(conf);
+
+  if (conf.recursive)
+    return run_recursive(conf);
+
   auto manager = client_manager();
   auto client = manager.make_client();
 
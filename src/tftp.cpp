@@ -19,7 +19,84 @@
  */
 #include "tftp/tftp.hpp"
 #include "tftp/filesystem.hpp"
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
 namespace tftp {
+/**
+ * @brief Finds the next NETASCII-special byte in a buffer.
+ * @details Scans for the next occurrence of `\r`, `\n`, or `\0`. The
+ * scan is vectorized (AVX2, SSE2 or NEON, whichever the build targets)
+ * so that clean runs between special bytes can be bulk-copied by the
+ * caller; the scalar loop handles the tail and non-SIMD builds.
+ * @param data The buffer to scan.
+ * @param len The length of the buffer.
+ * @returns The offset of the first special byte, or `len` if none.
+ */
+static inline auto find_special(const char *data,
+                                std::size_t len) noexcept -> std::size_t
+{
+  std::size_t pos = 0;
+
+#if defined(__AVX2__)
+  const auto cr_mask = _mm256_set1_epi8('\r');
+  const auto lf_mask = _mm256_set1_epi8('\n');
+  const auto nul_mask = _mm256_setzero_si256();
+  for (; pos + 32 <= len; pos += 32)
+  {
+    auto chunk =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + pos));
+    auto special = _mm256_or_si256(
+        _mm256_or_si256(_mm256_cmpeq_epi8(chunk, cr_mask),
+                        _mm256_cmpeq_epi8(chunk, lf_mask)),
+        _mm256_cmpeq_epi8(chunk, nul_mask));
+    auto mask = _mm256_movemask_epi8(special);
+    if (mask != 0)
+      return pos + static_cast<std::size_t>(__builtin_ctz(
+                       static_cast<unsigned>(mask)));
+  }
+#elif defined(__SSE2__)
+  const auto cr_mask = _mm_set1_epi8('\r');
+  const auto lf_mask = _mm_set1_epi8('\n');
+  const auto nul_mask = _mm_setzero_si128();
+  for (; pos + 16 <= len; pos += 16)
+  {
+    auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + pos));
+    auto special =
+        _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, cr_mask),
+                                  _mm_cmpeq_epi8(chunk, lf_mask)),
+                     _mm_cmpeq_epi8(chunk, nul_mask));
+    auto mask = _mm_movemask_epi8(special);
+    if (mask != 0)
+      return pos + static_cast<std::size_t>(__builtin_ctz(
+                       static_cast<unsigned>(mask)));
+  }
+#elif defined(__ARM_NEON)
+  const auto cr_mask = vdupq_n_u8('\r');
+  const auto lf_mask = vdupq_n_u8('\n');
+  const auto nul_mask = vdupq_n_u8('\0');
+  for (; pos + 16 <= len; pos += 16)
+  {
+    auto chunk = vld1q_u8(reinterpret_cast<const std::uint8_t *>(data + pos));
+    auto special = vorrq_u8(vorrq_u8(vceqq_u8(chunk, cr_mask),
+                                     vceqq_u8(chunk, lf_mask)),
+                            vceqq_u8(chunk, nul_mask));
+    if (vmaxvq_u8(special) != 0)
+      break; // The scalar loop finds the exact offset within the block.
+  }
+#endif
+
+  for (; pos < len; ++pos)
+  {
+    const auto chr = data[pos];
+    if (chr == '\r' || chr == '\n' || chr == '\0')
+      break;
+  }
+  return pos;
+}
 /**
  * @brief Inserts data into a buffer, handling NETASCII conversion.
  * @details This function appends data from a source span (`buf`) to a
@@ -51,9 +128,19 @@ static inline auto insert_data(std::vector<char> &buffer,
     return;
   }
 
-  // NETASCII/MAIL processing.
-  for (const auto chr : buf)
+  // NETASCII/MAIL processing. Clean runs between special bytes are
+  // bulk-copied; only `\r`, `\n` and `\0` need per-byte handling.
+  std::size_t pos = 0;
+  while (pos < buf.size())
   {
+    auto run = find_special(buf.data() + pos, buf.size() - pos);
+    buffer.insert(buffer.end(), buf.begin() + pos, buf.begin() + pos + run);
+    pos += run;
+    if (pos >= buf.size())
+      break;
+
+    const auto chr = buf[pos++];
+
     // Skip bare \0 bytes so as to not confuse \r\0 handling.
     if (chr == '\0')
       continue;
@@ -82,26 +169,91 @@ static inline auto insert_data(std::vector<char> &buffer,
   }
 }
 
+/** @brief The number of prepared DATA blocks the chunk source keeps
+ * ahead of the consumer. */
+static constexpr auto READAHEAD_DEPTH = 2UL;
+
+/**
+ * @brief The read stage of a file transfer: yields prepared DATA blocks.
+ * @details A coroutine built on `detail::generator`. Each yielded span
+ * is a ready-to-send block laid out as `[header][payload]` with the
+ * DATA header fields left for the adopter to stamp. Before every yield
+ * the coroutine tops a small ring up to `READAHEAD_DEPTH` prepared
+ * blocks, so the file reads (and any NETASCII expansion via
+ * `insert_data()`) run while their predecessors are still in flight
+ * instead of serializing with the round trips. NETASCII conversion can
+ * produce more data than fits in one packet; the excess is chained
+ * into the following block. A failed read finishes the coroutine
+ * early: the adopter maps an exhausted source that still has data due
+ * to `messages::ACCESS_VIOLATION`.
+ * @param file The read source; held by the coroutine frame.
+ * @param blksize The negotiated data block size.
+ * @param mode The transfer mode (`NETASCII` conversion applies).
+ * @returns A generator yielding one span per DATA block; each span is
+ * valid until the generator is advanced.
+ */
+static inline auto block_source(std::shared_ptr<std::fstream> file,
+                                std::uint16_t blksize, std::uint8_t mode)
+    -> detail::generator<std::span<const char>>
+{
+  const auto datamsg_maxlen = sizeof(messages::data) + blksize;
+  auto ready = std::deque<std::vector<char>>();
+  auto overflow = std::vector<char>();
+  auto read_buf = std::vector<char>(blksize);
+  auto more = true;
+
+  while (more || !ready.empty())
+  {
+    while (more && ready.size() < READAHEAD_DEPTH)
+    {
+      // Reserve space for a full data packet plus NETASCII expansion
+      // to prevent reallocations.
+      auto block = std::vector<char>();
+      block.reserve(datamsg_maxlen + blksize);
+      block.resize(sizeof(messages::data));
+      block.insert(block.end(), overflow.begin(), overflow.end());
+      overflow.clear();
+
+      if (block.size() < datamsg_maxlen)
+      {
+        auto read_size =
+            static_cast<std::streamsize>(datamsg_maxlen - block.size());
+        file->read(read_buf.data(), read_size);
+        if (file->bad()) [[unlikely]]
+          co_return; // GCOVR_EXCL_LINE
+
+        insert_data(block, std::span(read_buf.data(), file->gcount()), mode);
+      }
+
+      if (block.size() > datamsg_maxlen)
+      {
+        auto overflow_start =
+            block.begin() + static_cast<std::ptrdiff_t>(datamsg_maxlen);
+        overflow.assign(overflow_start, block.end());
+        block.erase(overflow_start, block.end());
+      }
+
+      // A full block is never final: a transfer only completes on a
+      // short block, so one more is due even at end of file.
+      more = block.size() == datamsg_maxlen || file->good();
+      ready.push_back(std::move(block));
+    }
+
+    co_yield std::span<const char>(ready.front().data(), ready.front().size());
+    ready.pop_front();
+  }
+}
+
 /**
  * @brief Prepares the next data block to be sent for a file transfer session.
- * @details This function constructs the next data packet to be sent to the
- * client.
- *
- * The session buffer is reused for each packet. If a previous operation (like
- * NETASCII conversion) resulted in more data than could fit in a single packet,
- * that "overflow" data is present at the end of the buffer. This function moves
- * that overflow data to the beginning of the buffer to be sent in the current
- * packet. The buffer layout is conceptualized as:
- * `[header][512 bytes data][overflow]`.
- *
- * To prevent reallocations, the buffer capacity is reserved to hold a full data
- * packet plus space for NETASCII expansion. The buffer is resized to at least
- * hold the DATA packet header.
- *
- * New file data is read into a temporary buffer. This data is then processed
- * for NETASCII conversion (if required for the session's mode) and appended to
- * the session buffer after the header and any overflow data.
- *
+ * @details This function adopts the next block prepared by the
+ * `block_source()` read stage into the session buffer and stamps its
+ * DATA header. The source is not advanced here: the caller runs
+ * `state_t::advance_read()` once the frame has been handed to the
+ * socket, so the following disk read overlaps the round trip of the
+ * block just adopted; a still-deferred advance runs at the top of the
+ * next call as a fallback. Octet-mode reads served from a file mapping
+ * skip the pipeline: the payload comes straight out of the mapping.
  * @param siter An iterator pointing to the current session in the sessions map.
  * @return std::uint16_t Returns 0 on success. If there is a file read error, it
  * returns `messages::ACCESS_VIOLATION`.
@@ -116,33 +268,72 @@ static inline auto send_next(session_t *siter) -> std::uint16_t
 
   state.block_num += 1; // block_num wraps on overflow.
 
-  buffer.reserve(messages::DATAMSG_MAXLEN + messages::DATALEN);
-  if (buffer.size() < sizeof(messages::data))
+  const auto datamsg_maxlen = sizeof(messages::data) + state.blksize;
+
+  if (state.map)
+  {
+    // Octet-mode fast path: the payload comes straight out of the file
+    // mapping, so only the header and one copy into the datagram buffer
+    // are needed. No NETASCII conversion or overflow handling applies.
     buffer.resize(sizeof(messages::data));
+    auto *msg = reinterpret_cast<messages::data *>(buffer.data());
+    msg->opc = htons(DATA);
+    msg->block_num = htons(state.block_num);
+
+    auto take = std::min<std::size_t>(state.blksize,
+                                      state.map->size() - state.map_offset);
+    if (take > 0)
+    {
+      const auto *src = state.map->data() + state.map_offset;
+      buffer.insert(buffer.end(), src, src + take);
+      state.map_offset += take;
+    }
+
+    // A short (or empty) block terminates the transfer.
+    if (take < state.blksize)
+      state.map_eof = true;
+
+    return 0;
+  }
 
-  auto data_start = buffer.begin() + sizeof(messages::data);
+  // A caller that never ran the deferred advance catches up here.
+  state.advance_read();
 
-  if (buffer.size() > messages::DATAMSG_MAXLEN)
+  // Start (or restart, after a rewind) the read stage on demand. A
+  // source that finishes without yielding stopped on a failed read.
+  if (state.chunk == std::default_sentinel)
   {
-    auto overflow_start = data_start + messages::DATALEN;
-    data_start = std::copy(overflow_start, buffer.end(), data_start);
+    state.source = block_source(state.file, state.blksize, state.mode);
+    state.chunk = state.source.begin();
+    if (state.chunk == std::default_sentinel) [[unlikely]]
+      return messages::ACCESS_VIOLATION; // GCOVR_EXCL_LINE
   }
 
-  data_start = buffer.erase(data_start, buffer.end());
+  // Adopt the block prepared while its predecessor was in flight; the
+  // copy is exactly the frame on the wire.
+  const auto block = *state.chunk;
+  buffer.reserve(datamsg_maxlen + state.blksize);
+  buffer.assign(block.begin(), block.end());
 
   auto *msg = reinterpret_cast<messages::data *>(buffer.data());
   msg->opc = htons(DATA);
   msg->block_num = htons(state.block_num);
 
-  auto read_size =
-      static_cast<std::streamsize>(messages::DATAMSG_MAXLEN - buffer.size());
-  auto read_buf = std::array<char, messages::DATALEN>();
-  state.file->read(read_buf.data(), read_size);
-  if (state.file->bad()) [[unlikely]]
-    return messages::ACCESS_VIOLATION; // GCOVR_EXCL_LINE
+  if (block.size() < datamsg_maxlen)
+  {
+    // The final short block has no successor read worth overlapping;
+    // finishing the source now keeps the transfer's end visible to
+    // read_pending().
+    ++state.chunk;
+  }
+  else
+  {
+    // Defer the advance — and with it the next disk read — until the
+    // adopted block has been handed to the socket, so the read
+    // overlaps the block's round trip instead of delaying its send.
+    state.advance_pending = true;
+  }
 
-  insert_data(buffer, std::span(read_buf.data(), state.file->gcount()),
-              state.mode);
   return 0;
 }
 
@@ -177,12 +368,20 @@ auto handle_request(messages::request req, session_t *siter) -> std::uint16_t
   {
     state.file = filesystem::open_write(state.target, state.tmp, err);
   }
+  else if (req.mode == messages::OCTET)
+  {
+    // Octet-mode reads are served from a file mapping; fall back to an
+    // fstream if the file cannot be mapped.
+    state.map = filesystem::open_map(state.target, err);
+    if (!state.map)
+      state.file = filesystem::open_read(state.target, err);
+  }
   else
   {
     state.file = filesystem::open_read(state.target, err);
   }
 
-  if (!state.file)
+  if (!state.file && !state.map)
   {
     if (err == std::errc::no_such_file_or_directory)
     {
@@ -214,13 +413,59 @@ auto handle_ack(messages::ack ack, session_t *siter) -> std::uint16_t
   auto &session = *siter;
   auto &state = session.state;
 
-  if ((!state.file->eof() || state.buffer.size() >= messages::DATAMSG_MAXLEN) &&
-      ntohs(ack.block_num) == state.block_num)
-  {
+  if (ntohs(ack.block_num) != state.block_num)
+    return 0;
+
+  if (state.read_pending())
     return send_next(siter);
-  }
 
-  if (ntohs(ack.block_num) == state.block_num)
+  // The final block has been acknowledged; release the read source.
+  if (state.map)
+    state.map.reset();
+  else
+    state.file->close();
+
+  return 0;
+}
+
+/**
+ * @brief Handles a DATA message on a multicast session (RFC 2090).
+ * @details Blocks may arrive in any order, so each payload lands at
+ * its block offset in the preallocated destination and its receipt
+ * flag is set; `block_num` tracks the highest block below the first
+ * gap, which is what a master client acknowledges. The coalescing
+ * writeback stage only suits sequential arrivals and is bypassed.
+ * @param data A pointer to the start of the data message.
+ * @param len The length of the data message.
+ * @param siter A pointer to the TFTP session.
+ * @returns 0 on success, a TFTP error code otherwise.
+ */
+static auto handle_multicast_data(const messages::data *data, std::size_t len,
+                                  session_t *siter) -> std::uint16_t
+{
+  auto &state = siter->state;
+  const auto block = ntohs(data->block_num);
+
+  if (block == 0 || state.block_received(block))
+    return 0;
+
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+  const auto *payload = reinterpret_cast<const char *>(data) + sizeof(*data);
+  len -= sizeof(*data);
+
+  const auto offset = static_cast<std::streamoff>(block - 1) * state.blksize;
+  state.file->seekp(offset);
+  state.file->write(payload, static_cast<std::streamsize>(len));
+  if (state.file->fail())
+    return messages::DISK_FULL; // GCOVR_EXCL_LINE
+
+  state.mark_block(block);
+  if (len < state.blksize)
+    state.mc_final = block;
+
+  // The transfer completes once every block up to the short final
+  // block has landed.
+  if (state.mc_final != 0 && state.block_num == state.mc_final)
     state.file->close();
 
   return 0;
@@ -233,6 +478,10 @@ auto handle_data(const messages::data *data, std::size_t len,
 
   auto &session = *siter;
   auto &block_num = session.state.block_num;
+  auto &blksize = session.state.blksize;
+
+  if (session.state.multicast)
+    return handle_multicast_data(data, len, siter);
 
   // Wraps block_num around
   auto next_block = static_cast<std::uint16_t>(block_num + 1);
@@ -244,15 +493,22 @@ auto handle_data(const messages::data *data, std::size_t len,
   len -= sizeof(*data);
   block_num = next_block;
 
-  // Write the data to the file.
-  auto &file = session.state.file;
-  file->write(payload, static_cast<std::streamsize>(len));
-  if (file->fail())
-    return messages::DISK_FULL; // GCOVR_EXCL_LINE
+  // Stage the payload for a coalesced write: a per-block fstream write
+  // sits disk latency inside the packet-processing path, where it
+  // inflates the measured RTT.
+  auto &state = session.state;
+  state.stage_write({payload, len});
+
+  const auto final_block = len < blksize;
+  if (final_block || state.writeback.size() >= session_t::WRITEBACK_MAX)
+  {
+    if (!state.flush_writeback())
+      return messages::DISK_FULL; // GCOVR_EXCL_LINE
+  }
 
   // File writing is complete.
-  if (len < messages::DATALEN)
-    file->close();
+  if (final_block)
+    state.file->close();
 
   return 0;
 }
@@ -18,6 +18,8 @@
  * @brief This file defines the TFTP client.
  */
 #include "tftp/tftp_client.hpp"
+
+#include <algorithm>
 namespace tftp {
 
 auto client_manager::client_t::connect(
@@ -28,32 +30,65 @@ auto client_manager::client_t::connect(
 
 auto client_manager::client_t::put(
     io::socket::socket_address<sockaddr_in6> server_addr, std::string local,
-    std::string remote, std::uint8_t mode) const noexcept -> client::put_file_t
+    std::string remote, std::uint8_t mode, std::uint16_t blksize,
+    std::uint16_t windowsize, std::uint8_t timeout,
+    client::client_sender::progress_t *progress,
+    std::uint64_t rate) const noexcept -> client::put_file_t
 {
   return {{.server_addr = server_addr,
            .local = std::move(local),
            .remote = std::move(remote),
            .ctx = ctx,
-           .mode = mode}};
+           .pool = pool,
+           .metrics = metrics,
+           .progress = progress,
+           .mode = mode,
+           .blksize = blksize,
+           .windowsize = windowsize,
+           .timeout = timeout,
+           .rate = rate}};
 }
 
 auto client_manager::client_t::get(
     io::socket::socket_address<sockaddr_in6> server_addr, std::string remote,
-    std::string local, std::uint8_t mode) const noexcept -> client::get_file_t
+    std::string local, std::uint8_t mode, std::uint16_t blksize,
+    std::uint16_t windowsize, std::uint8_t timeout,
+    client::client_sender::progress_t *progress, std::uint64_t rate,
+    bool multicast) const noexcept -> client::get_file_t
 {
   return {{.server_addr = server_addr,
            .local = std::move(local),
            .remote = std::move(remote),
            .ctx = ctx,
-           .mode = mode}};
+           .pool = pool,
+           .metrics = metrics,
+           .progress = progress,
+           .mode = mode,
+           .blksize = blksize,
+           .windowsize = windowsize,
+           .timeout = timeout,
+           .rate = rate},
+          multicast};
+}
+
+client_manager::client_manager(std::size_t contexts)
+{
+  contexts = std::max<std::size_t>(contexts, 1);
+  ctxs_.reserve(contexts);
+  for (std::size_t i = 0; i < contexts; ++i)
+    ctxs_.push_back(std::make_unique<context_thread>());
 }
 
 auto client_manager::make_client() -> client_t
 {
-  if (ctx_.state == ctx_.PENDING)
-    ctx_.start();
+  auto index = next_.fetch_add(1, std::memory_order_relaxed) % ctxs_.size();
+  auto &ctx = *ctxs_[index];
+  if (ctx.state == ctx.PENDING)
+    ctx.start();
 
-  return {.ctx = std::addressof(ctx_)};
+  return {.ctx = std::addressof(ctx),
+          .pool = std::addressof(pool_),
+          .metrics = std::addressof(metrics_)};
 } // GCOVR_EXCL_LINE
 
 } // namespace tftp
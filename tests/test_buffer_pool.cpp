@@ -0,0 +1,69 @@
+/* Copyright (C) 2025 Kevin Exton (kevin.exton@pm.me)
+ *
+ * tftp is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tftp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tftp.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// NOLINTBEGIN
+#include "tftp/detail/buffer_pool.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace tftp::detail;
+
+TEST(BufferPoolTest, AcquireReservesRequestedCapacity)
+{
+  auto pool = buffer_pool();
+
+  auto buffer = pool.acquire(1024);
+
+  EXPECT_TRUE(buffer.empty());
+  EXPECT_GE(buffer.capacity(), 1024);
+}
+
+TEST(BufferPoolTest, ReleaseRecyclesStorage)
+{
+  auto pool = buffer_pool();
+
+  auto buffer = pool.acquire(1024);
+  buffer.resize(512, 'x');
+  pool.release(std::move(buffer));
+
+  EXPECT_EQ(pool.size(), 1);
+
+  auto recycled = pool.acquire(256);
+
+  EXPECT_EQ(pool.size(), 0);
+  EXPECT_TRUE(recycled.empty());
+  EXPECT_GE(recycled.capacity(), 1024);
+}
+
+TEST(BufferPoolTest, IgnoresEmptyBuffers)
+{
+  auto pool = buffer_pool();
+
+  pool.release(std::vector<char>());
+
+  EXPECT_EQ(pool.size(), 0);
+}
+
+TEST(BufferPoolTest, FreeListIsBounded)
+{
+  auto pool = buffer_pool();
+
+  for (std::size_t i = 0; i < 2 * buffer_pool::MAX_POOLED; ++i)
+    pool.release(std::vector<char>(64));
+
+  EXPECT_EQ(pool.size(), buffer_pool::MAX_POOLED);
+}
+// NOLINTEND
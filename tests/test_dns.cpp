@@ -94,4 +94,91 @@ TEST(DnsTest, MakeErrorCodeSystem)
   EXPECT_EQ(ec.value(), EAFNOSUPPORT);
   EXPECT_EQ(ec.category(), std::system_category());
 }
+
+static auto make_loopback(std::uint16_t port) -> sockaddr_in
+{
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  return addr;
+}
+
+TEST(AddressCacheTest, LookupMissesOnEmptyCache)
+{
+  dns::address_cache::instance().clear();
+
+  EXPECT_FALSE(dns::address_cache::instance().lookup("localhost:69"));
+}
+
+TEST(AddressCacheTest, LookupReturnsInsertedAddress)
+{
+  auto &cache = dns::address_cache::instance();
+  cache.clear();
+
+  auto addr = make_loopback(69);
+  cache.insert("localhost:69", reinterpret_cast<sockaddr *>(&addr),
+               sizeof(addr));
+
+  auto cached = cache.lookup("localhost:69");
+  ASSERT_TRUE(cached);
+  EXPECT_EQ(cached->length, sizeof(addr));
+
+  auto *stored = reinterpret_cast<sockaddr_in *>(&cached->storage);
+  EXPECT_EQ(stored->sin_family, AF_INET);
+  EXPECT_EQ(stored->sin_port, htons(69));
+  EXPECT_EQ(stored->sin_addr.s_addr, htonl(INADDR_LOOPBACK));
+}
+
+TEST(AddressCacheTest, KeysAreIndependent)
+{
+  auto &cache = dns::address_cache::instance();
+  cache.clear();
+
+  auto addr = make_loopback(69);
+  cache.insert("localhost:69", reinterpret_cast<sockaddr *>(&addr),
+               sizeof(addr));
+
+  EXPECT_TRUE(cache.lookup("localhost:69"));
+  EXPECT_FALSE(cache.lookup("localhost:6969"));
+}
+
+TEST(AddressCacheTest, ExpiredEntriesAreEvicted)
+{
+  auto &cache = dns::address_cache::instance();
+  cache.clear();
+
+  auto addr = make_loopback(69);
+  cache.insert("localhost:69", reinterpret_cast<sockaddr *>(&addr),
+               sizeof(addr), dns::address_cache::duration(0));
+
+  EXPECT_FALSE(cache.lookup("localhost:69"));
+}
+
+TEST(AddressCacheTest, InsertRefreshesAnEntry)
+{
+  auto &cache = dns::address_cache::instance();
+  cache.clear();
+
+  auto addr = make_loopback(69);
+  cache.insert("localhost:69", reinterpret_cast<sockaddr *>(&addr),
+               sizeof(addr), dns::address_cache::duration(0));
+  cache.insert("localhost:69", reinterpret_cast<sockaddr *>(&addr),
+               sizeof(addr));
+
+  EXPECT_TRUE(cache.lookup("localhost:69"));
+}
+
+TEST(AddressCacheTest, ClearDropsEveryEntry)
+{
+  auto &cache = dns::address_cache::instance();
+  cache.clear();
+
+  auto addr = make_loopback(69);
+  cache.insert("localhost:69", reinterpret_cast<sockaddr *>(&addr),
+               sizeof(addr));
+  cache.clear();
+
+  EXPECT_FALSE(cache.lookup("localhost:69"));
+}
 // NOLINTEND
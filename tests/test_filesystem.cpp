@@ -21,6 +21,7 @@
 #include <filesystem>
 #include <fstream>
 #include <gtest/gtest.h>
+#include <string_view>
 #include <system_error>
 
 using namespace tftp::filesystem;
@@ -76,6 +77,26 @@ TEST_F(TestFileSystem, NextIncrementsCounter)
   EXPECT_EQ(count().load(), initial_count + 3);
 }
 
+TEST_F(TestFileSystem, NextBesideTargetIsHiddenInTargetDirectory)
+{
+  const auto target = std::filesystem::path("/some/dir/file.img");
+  const auto path = tmpname(target);
+  const auto filename = path.filename().string();
+
+  EXPECT_EQ(path.parent_path(), target.parent_path());
+  EXPECT_TRUE(filename.starts_with(".file.img."));
+  EXPECT_NE(filename.find("tftp."), std::string::npos);
+}
+
+TEST_F(TestFileSystem, NextBesideTargetIncrementsCounter)
+{
+  const auto target = std::filesystem::path("/some/dir/file.img");
+  const auto path1 = tmpname(target);
+  const auto path2 = tmpname(target);
+
+  EXPECT_NE(path1, path2);
+}
+
 TEST_F(TestFileSystem, TouchCreatesNewFile)
 {
   const auto path = tmpname();
@@ -168,6 +189,49 @@ TEST_F(TestFileSystem, OpenReadReturnsErrorOnPermissionDenied)
   std::filesystem::remove(path);
 }
 
+TEST_F(TestFileSystem, OpenMapMapsFileContents)
+{
+  const auto path = tmpname();
+  std::ofstream(path) << "mapped data";
+
+  std::error_code err;
+  auto map = open_map(path, err);
+
+  ASSERT_TRUE(map);
+  EXPECT_FALSE(err);
+  EXPECT_EQ(std::string_view(map->data(), map->size()), "mapped data");
+
+  std::filesystem::remove(path);
+}
+
+TEST_F(TestFileSystem, OpenMapReturnsEmptyMapOnEmptyFile)
+{
+  const auto path = tmpname();
+  std::ofstream(path).flush();
+
+  std::error_code err;
+  auto map = open_map(path, err);
+
+  ASSERT_TRUE(map);
+  EXPECT_FALSE(err);
+  EXPECT_EQ(map->size(), 0);
+
+  std::filesystem::remove(path);
+}
+
+TEST_F(TestFileSystem, OpenMapReturnsErrorOnNonExistentFile)
+{
+  const auto path = tmpname();
+  std::filesystem::remove(path);
+
+  std::error_code err;
+  auto map = open_map(path, err);
+
+  EXPECT_FALSE(map);
+  EXPECT_TRUE(err);
+  EXPECT_EQ(err, std::errc::no_such_file_or_directory);
+}
+
 TEST_F(TestFileSystem, OpenWriteOpensTempFileForWriting)
 {
   const auto path = tmpname();
@@ -178,6 +242,7 @@ TEST_F(TestFileSystem, OpenWriteOpensTempFileForWriting)
   EXPECT_TRUE(fstream->is_open());
   EXPECT_FALSE(err);
   EXPECT_TRUE(std::filesystem::exists(tmp));
+  EXPECT_EQ(tmp.parent_path(), path.parent_path());
 
   std::filesystem::remove(path);
   std::filesystem::remove(tmp);
@@ -197,23 +262,23 @@ TEST_F(TestFileSystem, OpenWriteReturnsErrorOnUncreatableDestFile)
 TEST_F(TestFileSystem, OpenWriteReturnsErrorOnUncreatableTempFile)
 {
   std::error_code err;
-  const auto path = tmpname();
-  touch(path);
+  const auto target = std::filesystem::path("/tmp/test");
+  const auto blocker = tmpname(target);
+  touch(blocker);
   std::filesystem::path tmp;
 
   count()--;
 
-  std::filesystem::permissions(path, std::filesystem::perms::owner_read |
-                                         std::filesystem::perms::group_read |
-                                         std::filesystem::perms::others_read);
+  std::filesystem::permissions(blocker, std::filesystem::perms::owner_read |
+                                            std::filesystem::perms::group_read |
+                                            std::filesystem::perms::others_read);
 
-  auto target = std::filesystem::path("/tmp/test");
   auto fstream = open_write(target, tmp, err);
 
   EXPECT_FALSE(fstream);
   EXPECT_EQ(err, std::errc::permission_denied);
 
-  std::filesystem::remove(path);
+  std::filesystem::remove(blocker);
   std::filesystem::remove(target);
 }
 // NOLINTEND
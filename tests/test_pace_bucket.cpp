@@ -0,0 +1,127 @@
+/* Copyright (C) 2025 Kevin Exton (kevin.exton@pm.me)
+ *
+ * tftp is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tftp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tftp.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// NOLINTBEGIN
+#include "tftp/detail/pace_bucket.hpp"
+
+#include <gtest/gtest.h>
+
+#include <functional>
+
+using namespace tftp::detail;
+
+namespace {
+// A stub timer queue that records registrations and lets the test
+// drive the periodic tick by hand.
+struct stub_timers {
+  template <typename Callback>
+  auto add(pace_bucket::duration, Callback &&callback,
+           pace_bucket::duration) -> pace_bucket::timer_id
+  {
+    ++adds;
+    tick = [cb = std::forward<Callback>(callback)]() mutable { cb(0); };
+    return pace_bucket::INVALID_TIMER;
+  }
+
+  auto remove(pace_bucket::timer_id) -> pace_bucket::timer_id
+  {
+    ++removes;
+    tick = nullptr;
+    return pace_bucket::INVALID_TIMER;
+  }
+
+  int adds = 0;
+  int removes = 0;
+  std::function<void()> tick;
+};
+} // namespace
+
+TEST(PaceBucketTest, UnpacedBucketAdmitsEverything)
+{
+  pace_bucket pace;
+
+  EXPECT_EQ(pace.rate(), 0U);
+  for (int i = 0; i < 1000; ++i)
+    EXPECT_TRUE(pace.admit(65536));
+  EXPECT_FALSE(pace.blocked());
+}
+
+TEST(PaceBucketTest, AdmitsWithinTheTickBudget)
+{
+  // 1 GB/s accrues 2 MB per tick; a single block fits comfortably.
+  pace_bucket pace(1'000'000'000);
+
+  EXPECT_TRUE(pace.admit(512));
+  EXPECT_FALSE(pace.blocked());
+}
+
+TEST(PaceBucketTest, BlocksWhenTheBudgetIsExhausted)
+{
+  // 1 B/s accrues no usable credit on any test timescale.
+  pace_bucket pace(1);
+
+  EXPECT_FALSE(pace.admit(512));
+  EXPECT_TRUE(pace.blocked());
+}
+
+TEST(PaceBucketTest, ArmRegistersASingleTick)
+{
+  stub_timers timers;
+  pace_bucket pace(1);
+
+  pace.arm(timers, [] {});
+  pace.arm(timers, [] {});
+
+  EXPECT_EQ(timers.adds, 1);
+}
+
+TEST(PaceBucketTest, TickRedrivesOnlyWhileBlocked)
+{
+  stub_timers timers;
+  pace_bucket pace(1);
+  int drains = 0;
+
+  pace.arm(timers, [&] { ++drains; });
+  timers.tick();
+  EXPECT_EQ(drains, 0);
+
+  pace.admit(512);
+  EXPECT_TRUE(pace.blocked());
+  timers.tick();
+  EXPECT_EQ(drains, 1);
+
+  // The drain either sends or re-blocks; a bare tick stays quiet.
+  timers.tick();
+  EXPECT_EQ(drains, 1);
+}
+
+TEST(PaceBucketTest, CancelReleasesTheTimer)
+{
+  stub_timers timers;
+  pace_bucket pace(1);
+  int drains = 0;
+
+  pace.arm(timers, [&] { ++drains; });
+  pace.admit(512);
+  auto tick = timers.tick;
+  pace.cancel(timers);
+  tick();
+
+  EXPECT_FALSE(pace.blocked());
+  EXPECT_EQ(timers.removes, 1);
+  EXPECT_EQ(drains, 0);
+}
+// NOLINTEND
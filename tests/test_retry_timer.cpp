@@ -0,0 +1,133 @@
+/* Copyright (C) 2025 Kevin Exton (kevin.exton@pm.me)
+ *
+ * tftp is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tftp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tftp.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// NOLINTBEGIN
+#include "tftp/detail/retry_timer.hpp"
+
+#include <gtest/gtest.h>
+
+#include <functional>
+
+using namespace tftp::detail;
+
+namespace {
+// A stub timer queue that records registrations and lets the test
+// drive the periodic tick by hand.
+struct stub_timers {
+  template <typename Callback>
+  auto add(retry_timer::duration, Callback &&callback,
+           retry_timer::duration) -> retry_timer::timer_id
+  {
+    ++adds;
+    tick = [cb = std::forward<Callback>(callback)]() mutable { cb(0); };
+    return retry_timer::INVALID_TIMER;
+  }
+
+  auto remove(retry_timer::timer_id) -> retry_timer::timer_id
+  {
+    ++removes;
+    tick = nullptr;
+    return retry_timer::INVALID_TIMER;
+  }
+
+  int adds = 0;
+  int removes = 0;
+  std::function<void()> tick;
+};
+} // namespace
+
+TEST(RetryTimerTest, StartsDisarmed)
+{
+  retry_timer retry;
+
+  EXPECT_FALSE(retry.armed());
+}
+
+TEST(RetryTimerTest, ArmRegistersASingleTick)
+{
+  stub_timers timers;
+  retry_timer retry;
+
+  retry.arm(timers, retry_timer::duration(10), [](auto) {});
+  retry.arm(timers, retry_timer::duration(20), [](auto) {});
+
+  EXPECT_TRUE(retry.armed());
+  EXPECT_EQ(timers.adds, 1);
+}
+
+TEST(RetryTimerTest, TicksBeforeTheDeadlineAreDeferred)
+{
+  stub_timers timers;
+  retry_timer retry;
+  int expiries = 0;
+
+  retry.arm(timers, retry_timer::duration(1000), [&](auto) { ++expiries; });
+  timers.tick();
+
+  EXPECT_EQ(expiries, 0);
+}
+
+TEST(RetryTimerTest, ExpiryCountsConsecutiveTicks)
+{
+  stub_timers timers;
+  retry_timer retry;
+  std::uint32_t last = 0;
+
+  retry.arm(timers, retry_timer::duration(0), [&](auto count) {
+    last = count;
+  });
+  timers.tick();
+  EXPECT_EQ(last, 1);
+
+  // The deadline rearms at a 0ms delay, so the next tick fires again.
+  timers.tick();
+  EXPECT_EQ(last, 2);
+}
+
+TEST(RetryTimerTest, RescheduleResetsTheExpiryCount)
+{
+  stub_timers timers;
+  retry_timer retry;
+  std::uint32_t last = 0;
+
+  retry.arm(timers, retry_timer::duration(0), [&](auto count) {
+    last = count;
+  });
+  timers.tick();
+  timers.tick();
+  EXPECT_EQ(last, 2);
+
+  retry.reschedule(retry_timer::duration(0));
+  timers.tick();
+  EXPECT_EQ(last, 1);
+}
+
+TEST(RetryTimerTest, CancelStopsExpiries)
+{
+  stub_timers timers;
+  retry_timer retry;
+  int expiries = 0;
+
+  retry.arm(timers, retry_timer::duration(0), [&](auto) { ++expiries; });
+  auto tick = timers.tick;
+  retry.cancel(timers);
+  tick();
+
+  EXPECT_FALSE(retry.armed());
+  EXPECT_EQ(timers.removes, 1);
+  EXPECT_EQ(expiries, 0);
+}
+// NOLINTEND
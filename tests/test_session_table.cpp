@@ -0,0 +1,133 @@
+/* Copyright (C) 2025 Kevin Exton (kevin.exton@pm.me)
+ *
+ * tftp is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tftp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tftp.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// NOLINTBEGIN
+#include "tftp/detail/session_table.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace tftp;
+using detail::session_table;
+
+static auto make_addr(std::uint16_t port) -> session_table::key_type
+{
+  sockaddr_in6 addr{};
+  addr.sin6_family = AF_INET6;
+  addr.sin6_port = htons(port);
+  return session_table::key_type(addr);
+}
+
+TEST(SessionTableTest, StartsEmpty)
+{
+  auto table = session_table();
+
+  EXPECT_TRUE(table.empty());
+  EXPECT_EQ(table.size(), 0);
+  EXPECT_EQ(table.begin(), table.end());
+}
+
+TEST(SessionTableTest, EmplaceReturnsIteratorToSession)
+{
+  auto table = session_table();
+
+  auto siter = table.emplace(make_addr(69), session_t{});
+  siter->second.state.block_num = 42;
+
+  EXPECT_EQ(table.size(), 1);
+  EXPECT_EQ(table.find(make_addr(69))->second.state.block_num, 42);
+}
+
+TEST(SessionTableTest, FindReturnsEndForUnknownAddress)
+{
+  auto table = session_table();
+  table.emplace(make_addr(69), session_t{});
+
+  EXPECT_EQ(table.find(make_addr(70)), table.end());
+}
+
+TEST(SessionTableTest, AllowsDuplicateKeys)
+{
+  auto table = session_table();
+
+  table.emplace(make_addr(69), session_t{});
+  table.emplace(make_addr(69), session_t{});
+
+  EXPECT_EQ(table.size(), 2);
+}
+
+TEST(SessionTableTest, SurvivesGrowth)
+{
+  auto table = session_table();
+
+  for (std::uint16_t port = 1; port <= 100; ++port)
+  {
+    auto siter = table.emplace(make_addr(port), session_t{});
+    siter->second.state.block_num = port;
+  }
+
+  ASSERT_EQ(table.size(), 100);
+  for (std::uint16_t port = 1; port <= 100; ++port)
+  {
+    auto siter = table.find(make_addr(port));
+    ASSERT_NE(siter, table.end());
+    EXPECT_EQ(siter->second.state.block_num, port);
+  }
+}
+
+TEST(SessionTableTest, IteratesOverEverySession)
+{
+  auto table = session_table();
+  for (std::uint16_t port = 1; port <= 20; ++port)
+    table.emplace(make_addr(port), session_t{});
+
+  std::size_t count = 0;
+  for (auto &[addr, sess] : table)
+  {
+    (void)addr;
+    (void)sess;
+    ++count;
+  }
+
+  EXPECT_EQ(count, 20);
+}
+
+TEST(SessionTableTest, EraseKeepsProbeChainsIntact)
+{
+  auto table = session_table();
+  for (std::uint16_t port = 1; port <= 20; ++port)
+    table.emplace(make_addr(port), session_t{});
+
+  table.erase(table.find(make_addr(5)));
+
+  EXPECT_EQ(table.size(), 19);
+  EXPECT_EQ(table.find(make_addr(5)), table.end());
+  for (std::uint16_t port = 6; port <= 20; ++port)
+    EXPECT_NE(table.find(make_addr(port)), table.end());
+}
+
+TEST(SessionTableTest, ClearRemovesEverySession)
+{
+  auto table = session_table();
+  for (std::uint16_t port = 1; port <= 20; ++port)
+    table.emplace(make_addr(port), session_t{});
+
+  table.clear();
+
+  EXPECT_TRUE(table.empty());
+  EXPECT_EQ(table.begin(), table.end());
+  EXPECT_EQ(table.find(make_addr(1)), table.end());
+}
+// NOLINTEND
@@ -179,8 +179,9 @@ TEST_F(TestTftp, HandleRequest_RrqSuccessWithOctetMode)
   EXPECT_EQ(siter->second.state.opc, RRQ);
   EXPECT_EQ(siter->second.state.mode, OCTET);
   EXPECT_EQ(siter->second.state.target, test_file);
-  EXPECT_TRUE(siter->second.state.file);
-  EXPECT_TRUE(siter->second.state.file->is_open());
+  // Octet-mode reads are served from a file mapping, not an fstream.
+  EXPECT_TRUE(siter->second.state.map);
+  EXPECT_FALSE(siter->second.state.file);
   EXPECT_GT(siter->second.state.buffer.size(), sizeof(messages::data));
   EXPECT_EQ(siter->second.state.block_num, 1);
 
@@ -319,8 +320,8 @@ TEST_F(TestTftp, HandleAck_ClosesFileWhenTransferComplete)
   const auto test_file = create_test_file("short");
   auto siter = create_session();
 
-  // Initialize RRQ session
-  request req{.opc = RRQ, .mode = OCTET, .filename = test_file.c_str()};
+  // Initialize a NETASCII RRQ session so reads go through the fstream.
+  request req{.opc = RRQ, .mode = NETASCII, .filename = test_file.c_str()};
   handle_request(req, std::addressof(siter->second));
 
   // Buffer should be less than full for short file
@@ -337,6 +338,58 @@ TEST_F(TestTftp, HandleAck_ClosesFileWhenTransferComplete)
   std::filesystem::remove(test_file);
 }
 
+TEST_F(TestTftp, HandleAck_ReleasesMapWhenTransferComplete)
+{
+  const auto test_file = create_test_file("short");
+  auto siter = create_session();
+
+  // Initialize an octet RRQ session so reads go through the mapping.
+  request req{.opc = RRQ, .mode = OCTET, .filename = test_file.c_str()};
+  handle_request(req, std::addressof(siter->second));
+
+  ASSERT_TRUE(siter->second.state.map);
+  ASSERT_LT(siter->second.state.buffer.size(), DATAMSG_MAXLEN);
+  const auto final_block = siter->second.state.block_num;
+
+  ack ack_msg{.opc = htons(ACK), .block_num = htons(final_block)};
+
+  const auto result = handle_ack(ack_msg, std::addressof(siter->second));
+
+  EXPECT_EQ(result, 0);
+  EXPECT_FALSE(siter->second.state.map);
+
+  std::filesystem::remove(test_file);
+}
+
+TEST_F(TestTftp, HandleAck_SendsEmptyFinalBlockFromMap)
+{
+  // A file that is an exact multiple of the block size must be
+  // terminated with an empty DATA block.
+  const auto test_file = create_test_file(std::string(DATALEN, 'M'));
+  auto siter = create_session();
+
+  request req{.opc = RRQ, .mode = OCTET, .filename = test_file.c_str()};
+  handle_request(req, std::addressof(siter->second));
+
+  ASSERT_EQ(siter->second.state.buffer.size(), DATAMSG_MAXLEN);
+
+  ack ack_msg{.opc = htons(ACK), .block_num = htons(1)};
+  auto result = handle_ack(ack_msg, std::addressof(siter->second));
+
+  EXPECT_EQ(result, 0);
+  EXPECT_EQ(siter->second.state.block_num, 2);
+  EXPECT_EQ(siter->second.state.buffer.size(), sizeof(messages::data));
+
+  // The empty block completes the transfer.
+  ack_msg.block_num = htons(2);
+  result = handle_ack(ack_msg, std::addressof(siter->second));
+
+  EXPECT_EQ(result, 0);
+  EXPECT_FALSE(siter->second.state.map);
+
+  std::filesystem::remove(test_file);
+}
+
 TEST_F(TestTftp, HandleAck_IgnoresOldAck)
 {
   const auto test_file = create_test_file(std::string(1024, 'Y'));
@@ -595,4 +648,255 @@ TEST_F(TestTftp, HandleData_HandlesBlockNumberWrapAround)
   std::filesystem::remove(target_file);
 }
 
+TEST_F(TestTftp, HandleData_RespectsNegotiatedBlksize)
+{
+  const auto target_file = filesystem::tmpname();
+  std::filesystem::remove(target_file);
+  auto siter = create_session();
+
+  // Initialize WRQ session with a negotiated block size.
+  constexpr std::uint16_t blksize = 1024;
+  siter->second.state.blksize = blksize;
+  siter->second.state.file = std::make_shared<std::fstream>(
+      target_file, std::ios::out | std::ios::trunc | std::ios::binary);
+
+  // A 512-byte payload is a short packet when blksize is 1024.
+  std::vector<char> buffer(sizeof(messages::data) + DATALEN);
+  auto *data_msg = reinterpret_cast<messages::data *>(buffer.data());
+  data_msg->opc = htons(DATA);
+  data_msg->block_num = htons(1);
+  std::fill(buffer.begin() + sizeof(messages::data), buffer.end(), 'A');
+
+  const auto result =
+      handle_data(data_msg, buffer.size(), std::addressof(siter->second));
+
+  EXPECT_EQ(result, 0);
+  EXPECT_FALSE(siter->second.state.file->is_open());
+
+  std::filesystem::remove(target_file);
+}
+
+TEST_F(TestTftp, HandleData_CoalescesFullBlocksInWriteback)
+{
+  const auto target_file = filesystem::tmpname();
+  std::filesystem::remove(target_file);
+  auto siter = create_session();
+
+  siter->second.state.file = std::make_shared<std::fstream>(
+      target_file, std::ios::out | std::ios::trunc | std::ios::binary);
+
+  // Send full-size data block (512 bytes)
+  std::vector<char> buffer(sizeof(messages::data) + DATALEN);
+  auto *data_msg = reinterpret_cast<messages::data *>(buffer.data());
+  data_msg->opc = htons(DATA);
+  data_msg->block_num = htons(1);
+  std::fill(buffer.begin() + sizeof(messages::data), buffer.end(), 'A');
+
+  const auto result =
+      handle_data(data_msg, buffer.size(), std::addressof(siter->second));
+
+  // The payload is staged, not written through.
+  EXPECT_EQ(result, 0);
+  EXPECT_EQ(siter->second.state.writeback.size(), DATALEN);
+  EXPECT_EQ(std::filesystem::file_size(target_file), 0);
+
+  std::filesystem::remove(target_file);
+}
+
+TEST_F(TestTftp, HandleData_FlushesWritebackAtThreshold)
+{
+  const auto target_file = filesystem::tmpname();
+  std::filesystem::remove(target_file);
+  auto siter = create_session();
+
+  auto &state = siter->second.state;
+  state.file = std::make_shared<std::fstream>(
+      target_file, std::ios::out | std::ios::trunc | std::ios::binary);
+  state.writeback.assign(session_t::WRITEBACK_MAX, 'x');
+
+  // Send full-size data block (512 bytes)
+  std::vector<char> buffer(sizeof(messages::data) + DATALEN);
+  auto *data_msg = reinterpret_cast<messages::data *>(buffer.data());
+  data_msg->opc = htons(DATA);
+  data_msg->block_num = htons(1);
+  std::fill(buffer.begin() + sizeof(messages::data), buffer.end(), 'A');
+
+  const auto result =
+      handle_data(data_msg, buffer.size(), std::addressof(siter->second));
+
+  EXPECT_EQ(result, 0);
+  EXPECT_TRUE(state.writeback.empty());
+  EXPECT_TRUE(state.file->is_open());
+
+  state.file->close();
+  EXPECT_EQ(std::filesystem::file_size(target_file),
+            session_t::WRITEBACK_MAX + DATALEN);
+
+  std::filesystem::remove(target_file);
+}
+
+TEST_F(TestTftp, HandleData_MulticastAcceptsBlocksOutOfOrder)
+{
+  const auto target_file = filesystem::tmpname();
+  std::filesystem::remove(target_file);
+  auto siter = create_session();
+
+  auto &state = siter->second.state;
+  state.multicast = true;
+  state.file = std::make_shared<std::fstream>(
+      target_file, std::ios::out | std::ios::trunc | std::ios::binary);
+
+  // Block 2 lands first and waits on the gap at block 1.
+  std::vector<char> buffer2(sizeof(messages::data) + DATALEN);
+  auto *data_msg2 = reinterpret_cast<messages::data *>(buffer2.data());
+  data_msg2->opc = htons(DATA);
+  data_msg2->block_num = htons(2);
+  std::fill(buffer2.begin() + sizeof(messages::data), buffer2.end(), 'B');
+
+  auto result =
+      handle_data(data_msg2, buffer2.size(), std::addressof(siter->second));
+  EXPECT_EQ(result, 0);
+  EXPECT_EQ(state.block_num, 0); // Nothing contiguous yet.
+
+  // Block 1 fills the gap; the acknowledgeable prefix covers both.
+  std::vector<char> buffer1(sizeof(messages::data) + DATALEN);
+  auto *data_msg1 = reinterpret_cast<messages::data *>(buffer1.data());
+  data_msg1->opc = htons(DATA);
+  data_msg1->block_num = htons(1);
+  std::fill(buffer1.begin() + sizeof(messages::data), buffer1.end(), 'A');
+
+  result =
+      handle_data(data_msg1, buffer1.size(), std::addressof(siter->second));
+  EXPECT_EQ(result, 0);
+  EXPECT_EQ(state.block_num, 2);
+
+  // The short final block completes the transfer.
+  std::vector<char> buffer3(sizeof(messages::data) + 10);
+  auto *data_msg3 = reinterpret_cast<messages::data *>(buffer3.data());
+  data_msg3->opc = htons(DATA);
+  data_msg3->block_num = htons(3);
+  std::fill(buffer3.begin() + sizeof(messages::data), buffer3.end(), 'C');
+
+  result =
+      handle_data(data_msg3, buffer3.size(), std::addressof(siter->second));
+  EXPECT_EQ(result, 0);
+  EXPECT_EQ(state.block_num, 3);
+  EXPECT_FALSE(state.file->is_open());
+
+  // Every payload sits at its block offset.
+  std::ifstream in(target_file, std::ios::binary);
+  std::string content((std::istreambuf_iterator<char>(in)),
+                      std::istreambuf_iterator<char>());
+  EXPECT_EQ(content,
+            std::string(DATALEN, 'A') + std::string(DATALEN, 'B') + "CCCCCCCCCC");
+
+  std::filesystem::remove(target_file);
+}
+
+TEST_F(TestTftp, HandleData_MulticastIgnoresDuplicateBlocks)
+{
+  const auto target_file = filesystem::tmpname();
+  std::filesystem::remove(target_file);
+  auto siter = create_session();
+
+  auto &state = siter->second.state;
+  state.multicast = true;
+  state.file = std::make_shared<std::fstream>(
+      target_file, std::ios::out | std::ios::trunc | std::ios::binary);
+
+  std::vector<char> buffer(sizeof(messages::data) + DATALEN);
+  auto *data_msg = reinterpret_cast<messages::data *>(buffer.data());
+  data_msg->opc = htons(DATA);
+  data_msg->block_num = htons(1);
+  std::fill(buffer.begin() + sizeof(messages::data), buffer.end(), 'A');
+
+  auto result =
+      handle_data(data_msg, buffer.size(), std::addressof(siter->second));
+  EXPECT_EQ(result, 0);
+  EXPECT_EQ(state.block_num, 1);
+
+  // A repeat of block 1 neither rewrites the file nor moves the prefix.
+  std::fill(buffer.begin() + sizeof(messages::data), buffer.end(), 'X');
+  result =
+      handle_data(data_msg, buffer.size(), std::addressof(siter->second));
+  EXPECT_EQ(result, 0);
+  EXPECT_EQ(state.block_num, 1);
+
+  state.file->close();
+  std::ifstream in(target_file, std::ios::binary);
+  std::string content((std::istreambuf_iterator<char>(in)),
+                      std::istreambuf_iterator<char>());
+  EXPECT_EQ(content, std::string(DATALEN, 'A'));
+
+  std::filesystem::remove(target_file);
+}
+
+TEST_F(TestTftp, HandleData_MulticastKeepsTheFileOpenAcrossAGap)
+{
+  const auto target_file = filesystem::tmpname();
+  std::filesystem::remove(target_file);
+  auto siter = create_session();
+
+  auto &state = siter->second.state;
+  state.multicast = true;
+  state.file = std::make_shared<std::fstream>(
+      target_file, std::ios::out | std::ios::trunc | std::ios::binary);
+
+  // The short final block arrives while block 1 is still missing, so
+  // the transfer must stay open for the retransmission pass.
+  std::vector<char> buffer2(sizeof(messages::data) + 10);
+  auto *data_msg2 = reinterpret_cast<messages::data *>(buffer2.data());
+  data_msg2->opc = htons(DATA);
+  data_msg2->block_num = htons(2);
+  std::fill(buffer2.begin() + sizeof(messages::data), buffer2.end(), 'B');
+
+  auto result =
+      handle_data(data_msg2, buffer2.size(), std::addressof(siter->second));
+  EXPECT_EQ(result, 0);
+  EXPECT_EQ(state.mc_final, 2);
+  EXPECT_TRUE(state.file->is_open());
+
+  std::vector<char> buffer1(sizeof(messages::data) + DATALEN);
+  auto *data_msg1 = reinterpret_cast<messages::data *>(buffer1.data());
+  data_msg1->opc = htons(DATA);
+  data_msg1->block_num = htons(1);
+  std::fill(buffer1.begin() + sizeof(messages::data), buffer1.end(), 'A');
+
+  result =
+      handle_data(data_msg1, buffer1.size(), std::addressof(siter->second));
+  EXPECT_EQ(result, 0);
+  EXPECT_EQ(state.block_num, 2);
+  EXPECT_FALSE(state.file->is_open());
+
+  EXPECT_EQ(std::filesystem::file_size(target_file), DATALEN + 10);
+
+  std::filesystem::remove(target_file);
+}
+
+TEST_F(TestTftp, HandleAck_SendsLargerBlocksWithNegotiatedBlksize)
+{
+  constexpr std::uint16_t blksize = 1024;
+  const auto test_file = create_test_file(std::string(2 * blksize, 'x'));
+  auto siter = create_session();
+
+  siter->second.state.blksize = blksize;
+  request req{.opc = RRQ, .mode = OCTET, .filename = test_file.c_str()};
+  auto result = handle_request(req, std::addressof(siter->second));
+
+  ASSERT_EQ(result, 0);
+  EXPECT_EQ(siter->second.state.buffer.size(),
+            sizeof(messages::data) + blksize);
+
+  // Acknowledge block 1 and expect another full-size block.
+  ack ack_msg{.opc = ACK, .block_num = htons(1)};
+  result = handle_ack(ack_msg, std::addressof(siter->second));
+
+  EXPECT_EQ(result, 0);
+  EXPECT_EQ(siter->second.state.block_num, 2);
+  EXPECT_EQ(siter->second.state.buffer.size(),
+            sizeof(messages::data) + blksize);
+
+  std::filesystem::remove(test_file);
+}
+
 // NOLINTEND
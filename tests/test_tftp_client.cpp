@@ -29,6 +29,58 @@ TEST(TftpClientTest, MakeClient)
   EXPECT_NE(client.ctx, nullptr);
 }
 
+TEST(TftpClientTest, DefaultManagerHasSingleContext)
+{
+  auto manager = client_manager();
+
+  EXPECT_EQ(manager.contexts(), 1);
+}
+
+TEST(TftpClientTest, PooledManagerClampsZeroContexts)
+{
+  auto manager = client_manager(0);
+
+  EXPECT_EQ(manager.contexts(), 1);
+}
+
+TEST(TftpClientTest, PooledManagerDistributesClientsRoundRobin)
+{
+  auto manager = client_manager(2);
+
+  auto client1 = manager.make_client();
+  auto client2 = manager.make_client();
+  auto client3 = manager.make_client();
+
+  EXPECT_NE(client1.ctx, nullptr);
+  EXPECT_NE(client2.ctx, nullptr);
+  EXPECT_NE(client1.ctx, client2.ctx);
+  EXPECT_EQ(client1.ctx, client3.ctx);
+}
+
+TEST(TftpClientTest, ClientsShareManagerBufferPool)
+{
+  auto manager = client_manager(2);
+
+  auto client1 = manager.make_client();
+  auto client2 = manager.make_client();
+
+  EXPECT_NE(client1.pool, nullptr);
+  EXPECT_EQ(client1.pool, client2.pool);
+}
+
+TEST(TftpClientTest, ClientsShareManagerMetricsSink)
+{
+  auto manager = client_manager(2);
+  manager.set_metrics_sink([](const auto &) {});
+
+  auto client1 = manager.make_client();
+  auto client2 = manager.make_client();
+
+  EXPECT_NE(client1.metrics, nullptr);
+  EXPECT_EQ(client1.metrics, client2.metrics);
+  EXPECT_TRUE(static_cast<bool>(*client1.metrics));
+}
+
 TEST(TftpClientTest, Connect)
 {
   auto manager = client_manager();
@@ -72,6 +124,7 @@ TEST(ConnectTest, GetAddrInfoError)
 {
   using namespace stdexec;
 
+  tftp::dns::address_cache::instance().clear();
   getaddrinfo_err = EAI_FAIL;
   getaddrinfo_res = nullptr;
 
@@ -84,6 +137,7 @@ TEST(ConnectTest, GetAddrInfoError)
 
 TEST(ConnectTest, GetAddrInfoEmpty)
 {
+  tftp::dns::address_cache::instance().clear();
   getaddrinfo_err = 0;
   getaddrinfo_res = nullptr;
 
@@ -103,6 +157,7 @@ TEST(ConnectTest, GetAddrInfoEmpty)
 
 TEST(ConnectTest, Connects)
 {
+  tftp::dns::address_cache::instance().clear();
   getaddrinfo_err = 0;
 
   auto ai = new addrinfo;
@@ -128,6 +183,40 @@ TEST(ConnectTest, Connects)
   EXPECT_EQ(ptr->sin_addr.s_addr, htonl(INADDR_LOOPBACK));
 }
 
+TEST(ConnectTest, ServesRepeatLookupsFromTheCache)
+{
+  tftp::dns::address_cache::instance().clear();
+  getaddrinfo_err = 0;
+
+  auto ai = new addrinfo;
+  ai->ai_family = AF_INET;
+  ai->ai_socktype = SOCK_DGRAM;
+  ai->ai_protocol = IPPROTO_UDP;
+  ai->ai_addrlen = sizeof(sockaddr_in);
+  ai->ai_addr = (struct sockaddr *)new sockaddr_in;
+  ((struct sockaddr_in *)ai->ai_addr)->sin_family = AF_INET;
+  ((struct sockaddr_in *)ai->ai_addr)->sin_port = htons(69);
+  ((struct sockaddr_in *)ai->ai_addr)->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  ai->ai_next = nullptr;
+  getaddrinfo_res = ai;
+
+  auto manager = client_manager();
+  auto client = manager.make_client();
+  stdexec::sync_wait(client.connect("localhost", "69"));
+
+  // A failing resolver is invisible while the entry is cached.
+  getaddrinfo_err = EAI_FAIL;
+  getaddrinfo_res = nullptr;
+  auto [addr] = stdexec::sync_wait(client.connect("localhost", "69")).value();
+
+  ASSERT_EQ(addr->sin6_family, AF_INET);
+  auto *ptr = reinterpret_cast<sockaddr_in *>(std::ranges::data(addr));
+  EXPECT_EQ(ptr->sin_port, htons(69));
+  EXPECT_EQ(ptr->sin_addr.s_addr, htonl(INADDR_LOOPBACK));
+
+  getaddrinfo_err = 0;
+}
+
 TEST(TftpClientTest, PutFile)
 {
   auto manager = client_manager();
@@ -248,6 +337,42 @@ TEST(TftpClientTest, GetFileParameterOrder)
   EXPECT_EQ(get_sender.local, "destination.txt");
 }
 
+TEST(TftpClientTest, ProgressSnapshotDefaultsToNull)
+{
+  auto manager = client_manager();
+  auto client = manager.make_client();
+
+  io::socket::socket_address<sockaddr_in6> server_addr;
+
+  auto put_sender = client.put(server_addr, "local.txt", "remote.txt");
+  auto get_sender = client.get(server_addr, "remote.txt", "local.txt");
+
+  EXPECT_EQ(put_sender.progress, nullptr);
+  EXPECT_EQ(get_sender.progress, nullptr);
+}
+
+TEST(TftpClientTest, ProgressSnapshotIsThreadedThrough)
+{
+  auto manager = client_manager();
+  auto client = manager.make_client();
+
+  io::socket::socket_address<sockaddr_in6> server_addr;
+  auto progress = client::client_sender::progress_t{};
+
+  auto put_sender = client.put(server_addr, "local.txt", "remote.txt",
+                               messages::OCTET, messages::DATALEN,
+                               messages::WINDOWSIZE_MIN, 0, &progress);
+  auto get_sender = client.get(server_addr, "remote.txt", "local.txt",
+                               messages::OCTET, messages::DATALEN,
+                               messages::WINDOWSIZE_MIN, 0, &progress);
+
+  EXPECT_EQ(put_sender.progress, &progress);
+  EXPECT_EQ(get_sender.progress, &progress);
+  EXPECT_EQ(progress.bytes.load(), 0U);
+  EXPECT_EQ(progress.blocks.load(), 0U);
+  EXPECT_EQ(progress.retransmits.load(), 0U);
+}
+
 TEST(TftpClientTest, ConnectDefaultPort)
 {
   std::string hostname = "example.com";
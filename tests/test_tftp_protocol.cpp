@@ -36,6 +36,8 @@ TEST(TFTP_Protocol_Test, ErrStrCoverage)
   EXPECT_STREQ(errors::errstr(NO_SUCH_USER).data(), "No such user.");
   EXPECT_STREQ(errors::errstr(UNKNOWN_TID).data(), "Unknown TID.");
   EXPECT_STREQ(errors::errstr(ILLEGAL_OPERATION).data(), "Illegal operation.");
+  EXPECT_STREQ(errors::errstr(OPTION_REFUSED).data(),
+               "Option negotiation failed.");
   EXPECT_STREQ(errors::errstr(TIMED_OUT).data(), "Timed out.");
   EXPECT_STREQ(errors::errstr(NOT_DEFINED).data(), "Not defined.");
   EXPECT_STREQ(errors::errstr(FILE_ALREADY_EXISTS).data(),
@@ -365,4 +367,210 @@ TEST(ConstexprTest, ErrorsErrStrIsConstexpr)
   static_assert(errors::errstr(messages::ACCESS_VIOLATION)[0] == 'A');
 }
 
+// =============================================================================
+// Packet Builder Tests
+// =============================================================================
+
+TEST(AckMsgTest, BuildsNetworkOrderAck)
+{
+  auto buf = messages::ack_msg(0x0102);
+
+  EXPECT_EQ(buf.size(), sizeof(messages::ack));
+  EXPECT_EQ(buf[0], 0);
+  EXPECT_EQ(buf[1], messages::ACK);
+  EXPECT_EQ(buf[2], 0x01);
+  EXPECT_EQ(buf[3], 0x02);
+}
+
+TEST(AckMsgTest, AcknowledgesBlockZero)
+{
+  auto buf = messages::ack_msg(0);
+
+  EXPECT_EQ(buf[2], 0);
+  EXPECT_EQ(buf[3], 0);
+}
+
+TEST(OpcodeMsgTest, BuildsNetworkOrderOpcode)
+{
+  auto rrq = messages::opcode_msg(messages::RRQ);
+  auto wrq = messages::opcode_msg(messages::WRQ);
+
+  EXPECT_EQ(rrq[0], 0);
+  EXPECT_EQ(rrq[1], messages::RRQ);
+  EXPECT_EQ(wrq[0], 0);
+  EXPECT_EQ(wrq[1], messages::WRQ);
+}
+
+TEST(ConstexprTest, PacketBuildersAreConstexpr)
+{
+  static constexpr auto ack = messages::ack_msg(1);
+  static_assert(ack.size() == sizeof(messages::ack));
+
+  static constexpr auto rrq = messages::opcode_msg(messages::RRQ);
+  static_assert(rrq.size() == sizeof(std::uint16_t));
+}
+
+// =============================================================================
+// Option Parsing Tests (RFC 2347/2348)
+// =============================================================================
+
+TEST(ParseOptionsTest, EmptyBodyReturnsDefaults)
+{
+  auto opts = messages::parse_options("");
+
+  EXPECT_EQ(opts.blksize, messages::DATALEN);
+}
+
+TEST(ParseOptionsTest, ParsesBlksize)
+{
+  using namespace std::string_view_literals;
+  auto opts = messages::parse_options("blksize\0001428\0"sv);
+
+  EXPECT_EQ(opts.blksize, 1428);
+}
+
+TEST(ParseOptionsTest, BlksizeIsCaseInsensitive)
+{
+  using namespace std::string_view_literals;
+  auto opts = messages::parse_options("BlkSize\0008192\0"sv);
+
+  EXPECT_EQ(opts.blksize, 8192);
+}
+
+TEST(ParseOptionsTest, IgnoresOutOfRangeBlksize)
+{
+  using namespace std::string_view_literals;
+
+  EXPECT_EQ(messages::parse_options("blksize\0007\0"sv).blksize,
+            messages::DATALEN);
+  EXPECT_EQ(messages::parse_options("blksize\00065465\0"sv).blksize,
+            messages::DATALEN);
+}
+
+TEST(ParseOptionsTest, IgnoresMalformedValues)
+{
+  using namespace std::string_view_literals;
+
+  EXPECT_EQ(messages::parse_options("blksize\000abc\0"sv).blksize,
+            messages::DATALEN);
+  EXPECT_EQ(messages::parse_options("blksize\0"sv).blksize, messages::DATALEN);
+}
+
+TEST(ParseOptionsTest, IgnoresUnknownOptions)
+{
+  using namespace std::string_view_literals;
+  auto opts =
+      messages::parse_options("unknown\00042\0blksize\0002048\0"sv);
+
+  EXPECT_EQ(opts.blksize, 2048);
+}
+
+TEST(ParseOptionsTest, ParsesWindowsize)
+{
+  using namespace std::string_view_literals;
+  auto opts = messages::parse_options("windowsize\00016\0"sv);
+
+  EXPECT_EQ(opts.windowsize, 16);
+  EXPECT_EQ(opts.blksize, messages::DATALEN);
+}
+
+TEST(ParseOptionsTest, ParsesCombinedOptions)
+{
+  using namespace std::string_view_literals;
+  auto opts =
+      messages::parse_options("blksize\0001428\0windowsize\0008\0"sv);
+
+  EXPECT_EQ(opts.blksize, 1428);
+  EXPECT_EQ(opts.windowsize, 8);
+}
+
+TEST(ParseOptionsTest, IgnoresOutOfRangeWindowsize)
+{
+  using namespace std::string_view_literals;
+
+  EXPECT_EQ(messages::parse_options("windowsize\0000\0"sv).windowsize, 1);
+  EXPECT_EQ(messages::parse_options("windowsize\00065536\0"sv).windowsize, 1);
+}
+
+TEST(ParseOptionsTest, ParsesTsize)
+{
+  using namespace std::string_view_literals;
+  auto opts = messages::parse_options("tsize\00012345678\0"sv);
+
+  EXPECT_EQ(opts.tsize, 12345678);
+  EXPECT_EQ(opts.blksize, messages::DATALEN);
+}
+
+TEST(ParseOptionsTest, TsizeDefaultsToZero)
+{
+  using namespace std::string_view_literals;
+
+  EXPECT_EQ(messages::parse_options("").tsize, 0);
+  EXPECT_EQ(messages::parse_options("tsize\0000\0"sv).tsize, 0);
+}
+
+TEST(ParseOptionsTest, ParsesTimeout)
+{
+  using namespace std::string_view_literals;
+  auto opts = messages::parse_options("timeout\0005\0"sv);
+
+  EXPECT_EQ(opts.timeout, 5);
+}
+
+TEST(ParseOptionsTest, IgnoresOutOfRangeTimeout)
+{
+  using namespace std::string_view_literals;
+
+  EXPECT_EQ(messages::parse_options("timeout\0000\0"sv).timeout, 0);
+  EXPECT_EQ(messages::parse_options("timeout\000256\0"sv).timeout, 0);
+}
+
+TEST(ParseOptionsTest, ParsesMulticast)
+{
+  using namespace std::string_view_literals;
+  auto opts =
+      messages::parse_options("multicast\000224.0.1.1,1758,1\0"sv);
+
+  EXPECT_TRUE(opts.multicast);
+  EXPECT_EQ(opts.mc_addr, 0xE0000101);
+  EXPECT_EQ(opts.mc_port, 1758);
+  EXPECT_TRUE(opts.mc_master);
+}
+
+TEST(ParseOptionsTest, MulticastAllowsEmptyAddressAndPort)
+{
+  using namespace std::string_view_literals;
+  auto opts = messages::parse_options("multicast\000,,0\0"sv);
+
+  EXPECT_TRUE(opts.multicast);
+  EXPECT_EQ(opts.mc_addr, 0);
+  EXPECT_EQ(opts.mc_port, 0);
+  EXPECT_FALSE(opts.mc_master);
+}
+
+TEST(ParseOptionsTest, IgnoresMalformedMulticast)
+{
+  using namespace std::string_view_literals;
+
+  // Missing fields, out-of-range octets or ports, and a non-boolean
+  // master flag all invalidate the option.
+  EXPECT_FALSE(messages::parse_options("multicast\0\0"sv).multicast);
+  EXPECT_FALSE(messages::parse_options("multicast\000224.0.1.1,1758\0"sv)
+                   .multicast);
+  EXPECT_FALSE(messages::parse_options("multicast\000224.0.256.1,1758,1\0"sv)
+                   .multicast);
+  EXPECT_FALSE(messages::parse_options("multicast\000224.0.1.1,65536,1\0"sv)
+                   .multicast);
+  EXPECT_FALSE(messages::parse_options("multicast\000224.0.1.1,1758,2\0"sv)
+                   .multicast);
+}
+
+TEST(ParseOptionsTest, ParseOptionsIsConstexpr)
+{
+  using namespace std::string_view_literals;
+  static_assert(messages::parse_options("blksize\0001024\0"sv).blksize == 1024);
+  static_assert(
+      messages::parse_options("multicast\000224.0.1.1,1758,1\0"sv).multicast);
+}
+
 // NOLINTEND
@@ -62,14 +62,33 @@ TEST(SessionStateTest, StatisticsInitialization)
 {
   session_t::state_t state;
 
-  // avg_rtt should be initialized to TIMEOUT_MAX
-  EXPECT_EQ(state.statistics.avg_rtt, session_t::TIMEOUT_MAX);
+  // The RTO starts conservative until the first sample arrives.
+  EXPECT_EQ(state.statistics.rto, session_t::TIMEOUT_MAX);
+  EXPECT_EQ(state.statistics.srtt, session_t::duration(0));
+  EXPECT_EQ(state.statistics.rttvar, session_t::duration(0));
+  EXPECT_FALSE(state.statistics.sampled);
+  EXPECT_FALSE(state.statistics.retransmitted);
 
   // start_time should be initialized to some time in the past
   auto now = session_t::clock::now();
   EXPECT_LT(state.statistics.start_time, now);
 }
 
+TEST(SessionStateTest, StatisticsCountersStartAtZero)
+{
+  session_t::state_t state;
+
+  EXPECT_EQ(state.statistics.bytes_sent, 0);
+  EXPECT_EQ(state.statistics.bytes_received, 0);
+  EXPECT_EQ(state.statistics.blocks_sent, 0);
+  EXPECT_EQ(state.statistics.blocks_received, 0);
+  EXPECT_EQ(state.statistics.retransmits, 0);
+  EXPECT_EQ(state.statistics.duplicate_acks, 0);
+  EXPECT_EQ(state.statistics.timeouts, 0);
+  for (const auto &count : state.statistics.rtt_histogram)
+    EXPECT_EQ(count, 0);
+}
+
 TEST(SessionStateTest, PathAssignment)
 {
   session_t::state_t state;
@@ -113,6 +132,35 @@ TEST(SessionStateTest, FieldAssignments)
   EXPECT_EQ(state.mode, 2);
 }
 
+// =============================================================================
+// Multicast blockmap Tests (RFC 2090)
+// =============================================================================
+
+TEST(SessionStateTest, MarkBlockAdvancesOverTheContiguousPrefix)
+{
+  session_t::state_t state;
+
+  state.mark_block(2);
+  EXPECT_EQ(state.block_num, 0); // Block 1 is still missing.
+
+  state.mark_block(1);
+  EXPECT_EQ(state.block_num, 2); // The gap filled; both blocks count.
+
+  state.mark_block(3);
+  EXPECT_EQ(state.block_num, 3);
+}
+
+TEST(SessionStateTest, BlockReceivedGrowsTheBlockmapOnDemand)
+{
+  session_t::state_t state;
+
+  EXPECT_FALSE(state.block_received(1000));
+  state.mark_block(1000);
+  EXPECT_TRUE(state.block_received(1000));
+  EXPECT_FALSE(state.block_received(999));
+  EXPECT_FALSE(state.block_received(1001));
+}
+
 // =============================================================================
 // update_statistics Tests
 // =============================================================================
@@ -121,7 +169,6 @@ TEST(UpdateStatisticsTest, BasicUpdate)
 {
   session_t::state_t::statistics_t stats;
   stats.start_time = session_t::clock::now();
-  stats.avg_rtt = session_t::duration(100);
 
   // Sleep for a short time to create measurable RTT
   std::this_thread::sleep_for(std::chrono::milliseconds(10));
@@ -131,9 +178,9 @@ TEST(UpdateStatisticsTest, BasicUpdate)
   // Result should be reference to same stats
   EXPECT_EQ(&result, &stats);
 
-  // avg_rtt should be updated (EWMA: 75% old + 25% new)
-  EXPECT_GE(result.avg_rtt, session_t::TIMEOUT_MIN);
-  EXPECT_LE(result.avg_rtt, session_t::TIMEOUT_MAX);
+  // The RTO stays within the clamped range
+  EXPECT_GE(result.rto, session_t::TIMEOUT_MIN);
+  EXPECT_LE(result.rto, session_t::TIMEOUT_MAX);
 
   // start_time should be updated to now
   auto now = session_t::clock::now();
@@ -142,103 +189,158 @@ TEST(UpdateStatisticsTest, BasicUpdate)
   EXPECT_LT(diff, std::chrono::milliseconds(5));
 }
 
-TEST(UpdateStatisticsTest, EWMACalculation)
+TEST(UpdateStatisticsTest, FirstSampleSeedsEstimators)
 {
   session_t::state_t::statistics_t stats;
-  stats.avg_rtt = session_t::duration(100);
+  stats.start_time = session_t::clock::now() - session_t::duration(40);
+
+  session_t::update_statistics(stats);
+
+  // RFC 6298: SRTT = R, RTTVAR = R/2, RTO = SRTT + 4*RTTVAR = 3*R
+  EXPECT_TRUE(stats.sampled);
+  EXPECT_GE(stats.srtt.count(), 40);
+  EXPECT_LE(stats.srtt.count(), 45);
+  EXPECT_GE(stats.rttvar.count(), 20);
+  EXPECT_LE(stats.rttvar.count(), 23);
+  EXPECT_GE(stats.rto.count(), 120);
+  EXPECT_LE(stats.rto.count(), 135);
+}
+
+TEST(UpdateStatisticsTest, JacobsonKarelsBlend)
+{
+  session_t::state_t::statistics_t stats;
+  stats.sampled = true;
+  stats.srtt = session_t::duration(100);
+  stats.rttvar = session_t::duration(0);
   stats.start_time = session_t::clock::now() - session_t::duration(50);
 
   session_t::update_statistics(stats);
 
-  // EWMA formula: new_avg = old_avg * 3/4 + rtt * 1/4
-  // old_avg = 100, rtt ≈ 50, so new_avg ≈ 100*0.75 + 50*0.25 = 87.5
-  EXPECT_GE(stats.avg_rtt.count(), 80);
-  EXPECT_LE(stats.avg_rtt.count(), 95);
+  // RTTVAR = 0*3/4 + |100 - 50|/4 = 12, SRTT = 100*7/8 + 50/8 ≈ 93
+  EXPECT_GE(stats.srtt.count(), 88);
+  EXPECT_LE(stats.srtt.count(), 95);
+  EXPECT_GE(stats.rttvar.count(), 11);
+  EXPECT_LE(stats.rttvar.count(), 14);
+  // RTO = SRTT + 4*RTTVAR ≈ 141
+  EXPECT_GE(stats.rto.count(), 130);
+  EXPECT_LE(stats.rto.count(), 150);
+}
+
+TEST(UpdateStatisticsTest, KarnDiscardsRetransmittedSamples)
+{
+  session_t::state_t::statistics_t stats;
+  stats.retransmitted = true;
+  stats.start_time = session_t::clock::now() - session_t::duration(50);
+
+  session_t::update_statistics(stats);
+
+  // The ambiguous sample is discarded and the flag is cleared.
+  EXPECT_FALSE(stats.sampled);
+  EXPECT_FALSE(stats.retransmitted);
+  EXPECT_EQ(stats.rto, session_t::TIMEOUT_MAX);
+  for (const auto &count : stats.rtt_histogram)
+    EXPECT_EQ(count, 0);
+
+  // The next clean sample is taken as usual.
+  stats.start_time = session_t::clock::now() - session_t::duration(10);
+  session_t::update_statistics(stats);
+  EXPECT_TRUE(stats.sampled);
 }
 
 TEST(UpdateStatisticsTest, MinimumClamp)
 {
   session_t::state_t::statistics_t stats;
-  stats.avg_rtt = session_t::duration(5);
-  stats.start_time = session_t::clock::now() - session_t::duration(1);
+  stats.sampled = true;
+  stats.srtt = session_t::duration(1);
+  stats.rttvar = session_t::duration(0);
+  stats.start_time = session_t::clock::now();
 
   session_t::update_statistics(stats);
 
-  // EWMA: new_avg = old_avg * 3/4 + rtt * 1/4 = 5*0.75 + 1*0.25 = 4
-  // Should be clamped to TIMEOUT_MIN (2ms) or slightly higher due to timing
-  EXPECT_GE(stats.avg_rtt, session_t::TIMEOUT_MIN);
-  EXPECT_LE(stats.avg_rtt, session_t::duration(5));
+  // A near-zero SRTT and RTTVAR clamp the RTO up to TIMEOUT_MIN (2ms)
+  EXPECT_EQ(stats.rto, session_t::TIMEOUT_MIN);
 }
 
 TEST(UpdateStatisticsTest, MaximumClamp)
 {
   session_t::state_t::statistics_t stats;
-  stats.avg_rtt = session_t::TIMEOUT_MAX;
   stats.start_time = session_t::clock::now() - session_t::duration(300);
 
   session_t::update_statistics(stats);
 
   // Should be clamped to TIMEOUT_MAX (200ms)
-  EXPECT_EQ(stats.avg_rtt, session_t::TIMEOUT_MAX);
+  EXPECT_EQ(stats.rto, session_t::TIMEOUT_MAX);
+}
+
+TEST(UpdateStatisticsTest, NegotiatedCeilingRaisesMaximumClamp)
+{
+  session_t::state_t::statistics_t stats;
+  // A negotiated timeout option (RFC 2349) raises the RTO ceiling.
+  stats.rto_max = session_t::duration(5000);
+  stats.start_time = session_t::clock::now() - session_t::duration(1000);
+
+  session_t::update_statistics(stats);
+
+  // RTO = 3*R = 3000ms, allowed through by the raised ceiling.
+  EXPECT_GT(stats.rto, session_t::TIMEOUT_MAX);
+  EXPECT_LE(stats.rto, stats.rto_max);
 }
 
 TEST(UpdateStatisticsTest, MultipleUpdates)
 {
   session_t::state_t::statistics_t stats;
-  stats.avg_rtt = session_t::duration(100);
   stats.start_time = session_t::clock::now();
 
   std::this_thread::sleep_for(std::chrono::milliseconds(10));
   session_t::update_statistics(stats);
-  auto rtt1 = stats.avg_rtt;
+  auto rto1 = stats.rto;
 
   std::this_thread::sleep_for(std::chrono::milliseconds(10));
   session_t::update_statistics(stats);
-  auto rtt2 = stats.avg_rtt;
+  auto rto2 = stats.rto;
 
   std::this_thread::sleep_for(std::chrono::milliseconds(10));
   session_t::update_statistics(stats);
-  auto rtt3 = stats.avg_rtt;
+  auto rto3 = stats.rto;
 
-  // Each update should result in a different RTT
-  // (unless by coincidence they're the same after clamping)
-  EXPECT_GE(rtt1, session_t::TIMEOUT_MIN);
-  EXPECT_GE(rtt2, session_t::TIMEOUT_MIN);
-  EXPECT_GE(rtt3, session_t::TIMEOUT_MIN);
+  // Every computed RTO stays within the clamped range.
+  EXPECT_GE(rto1, session_t::TIMEOUT_MIN);
+  EXPECT_GE(rto2, session_t::TIMEOUT_MIN);
+  EXPECT_GE(rto3, session_t::TIMEOUT_MIN);
+  EXPECT_LE(rto3, session_t::TIMEOUT_MAX);
 }
 
 TEST(UpdateStatisticsTest, VeryShortRTT)
 {
   session_t::state_t::statistics_t stats;
-  stats.avg_rtt = session_t::duration(100);
+  stats.sampled = true;
+  stats.srtt = session_t::duration(100);
+  stats.rttvar = session_t::duration(8);
   stats.start_time = session_t::clock::now();
 
   // Call immediately (RTT ≈ 0)
   session_t::update_statistics(stats);
 
-  // EWMA: new_avg = 100*0.75 + 0*0.25 = 75
-  // But timing may vary slightly, so allow a range
-  EXPECT_GE(stats.avg_rtt, session_t::duration(70));
-  EXPECT_LE(stats.avg_rtt, session_t::duration(80));
+  // SRTT = 100*7/8 + 0/8 ≈ 87, but timing may vary slightly
+  EXPECT_GE(stats.srtt, session_t::duration(80));
+  EXPECT_LE(stats.srtt, session_t::duration(90));
 }
 
 TEST(UpdateStatisticsTest, ReferenceReturn)
 {
   session_t::state_t::statistics_t stats;
-  stats.avg_rtt = session_t::duration(100);
   stats.start_time = session_t::clock::now();
 
   auto &result = session_t::update_statistics(stats);
 
   // Modifying result should modify stats
-  result.avg_rtt = session_t::duration(50);
-  EXPECT_EQ(stats.avg_rtt, session_t::duration(50));
+  result.rto = session_t::duration(50);
+  EXPECT_EQ(stats.rto, session_t::duration(50));
 }
 
 TEST(UpdateStatisticsTest, PreservesAfterClamp)
 {
   session_t::state_t::statistics_t stats;
-  stats.avg_rtt = session_t::TIMEOUT_MAX;
   stats.start_time = session_t::clock::now() - session_t::duration(300);
 
   session_t::update_statistics(stats);
@@ -248,8 +350,8 @@ TEST(UpdateStatisticsTest, PreservesAfterClamp)
   session_t::update_statistics(stats);
 
   // Should still be within valid range
-  EXPECT_GE(stats.avg_rtt, session_t::TIMEOUT_MIN);
-  EXPECT_LE(stats.avg_rtt, session_t::TIMEOUT_MAX);
+  EXPECT_GE(stats.rto, session_t::TIMEOUT_MIN);
+  EXPECT_LE(stats.rto, session_t::TIMEOUT_MAX);
 }
 
 // =============================================================================
@@ -280,9 +382,9 @@ TEST(SessionTest, StateAccess)
 TEST(SessionTest, StatisticsAccess)
 {
   session_t session;
-  session.state.statistics.avg_rtt = session_t::duration(50);
+  session.state.statistics.srtt = session_t::duration(50);
 
-  EXPECT_EQ(session.state.statistics.avg_rtt, session_t::duration(50));
+  EXPECT_EQ(session.state.statistics.srtt, session_t::duration(50));
 }
 
 // =============================================================================
@@ -323,32 +425,57 @@ TEST(TypeAliasTest, SocketType)
 TEST(StatisticsEWMATest, VeryLargeRTT)
 {
   session_t::state_t::statistics_t stats;
-  stats.avg_rtt = session_t::duration(100);
   stats.start_time = session_t::clock::now() - session_t::duration(1000);
 
   session_t::update_statistics(stats);
 
   // Should be clamped to TIMEOUT_MAX
-  EXPECT_EQ(stats.avg_rtt, session_t::TIMEOUT_MAX);
+  EXPECT_EQ(stats.rto, session_t::TIMEOUT_MAX);
 }
 
 TEST(StatisticsEWMATest, GradualIncrease)
 {
   session_t::state_t::statistics_t stats;
-  stats.avg_rtt = session_t::TIMEOUT_MIN;
   stats.start_time = session_t::clock::now();
 
-  // Simulate gradually increasing RTT
+  // Simulate a steady RTT of roughly 5ms
   for (int i = 0; i < 10; i++)
   {
     std::this_thread::sleep_for(std::chrono::milliseconds(5));
     session_t::update_statistics(stats);
   }
 
-  // avg_rtt should have increased from minimum or stayed at minimum
-  // depending on actual measured RTT (which can be very small in tests)
-  EXPECT_GE(stats.avg_rtt, session_t::TIMEOUT_MIN);
-  EXPECT_LE(stats.avg_rtt, session_t::TIMEOUT_MAX);
+  // The RTO converges within the clamped range.
+  EXPECT_GE(stats.rto, session_t::TIMEOUT_MIN);
+  EXPECT_LE(stats.rto, session_t::TIMEOUT_MAX);
+}
+
+TEST(UpdateStatisticsTest, RecordsHistogramSample)
+{
+  session_t::state_t::statistics_t stats;
+  stats.start_time = session_t::clock::now() - session_t::duration(10);
+
+  session_t::update_statistics(stats);
+
+  // A ~10ms sample lands in the log2 bucket for [8, 16).
+  std::uint64_t total = 0;
+  for (const auto &count : stats.rtt_histogram)
+    total += count;
+  EXPECT_EQ(total, 1);
+  EXPECT_GE(stats.rtt_histogram[4], 1);
+}
+
+TEST(UpdateStatisticsTest, LargeSamplesLandInLastBucket)
+{
+  session_t::state_t::statistics_t stats;
+  stats.start_time = session_t::clock::now() - session_t::duration(1000);
+
+  session_t::update_statistics(stats);
+
+  // Samples past the covered range aggregate in the last bucket.
+  constexpr auto LAST =
+      session_t::state_t::statistics_t::RTT_BUCKETS - 1;
+  EXPECT_EQ(stats.rtt_histogram[LAST], 1);
 }
 
 TEST(StatisticsEWMATest, StartTimeUpdated)
@@ -356,7 +483,6 @@ TEST(StatisticsEWMATest, StartTimeUpdated)
   session_t::state_t::statistics_t stats;
   auto initial_time = session_t::clock::now();
   stats.start_time = initial_time;
-  stats.avg_rtt = session_t::duration(100);
 
   std::this_thread::sleep_for(std::chrono::milliseconds(20));
   session_t::update_statistics(stats);
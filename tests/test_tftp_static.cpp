@@ -491,4 +491,85 @@ TEST_F(TestTftpStatic, SendNext_HandlesMultipleCallsOnLargeFile)
   }
 }
 
+TEST_F(TestTftpStatic, SendNext_PreparesTheFollowingBlockAhead)
+{
+  session_t session;
+  const std::string content(1024, 'B');
+  const auto test_file = create_test_file(content);
+
+  session.state.file = std::make_shared<std::fstream>(
+      test_file, std::ios::in | std::ios::binary);
+  session.state.mode = OCTET;
+  session.state.block_num = 0;
+  session.state.buffer.resize(sizeof(messages::data));
+
+  auto result = send_next(&session);
+
+  // Block 2 is already staged while block 1 is in flight.
+  EXPECT_EQ(result, 0);
+  EXPECT_TRUE(session.state.chunk != std::default_sentinel);
+  EXPECT_TRUE(session.state.read_pending());
+
+  // Adopting the staged block serves the second half of the file.
+  result = send_next(&session);
+  EXPECT_EQ(result, 0);
+  EXPECT_EQ(session.state.block_num, 2);
+  const auto data_content =
+      std::string(session.state.buffer.begin() + sizeof(messages::data),
+                  session.state.buffer.end());
+  EXPECT_EQ(data_content, content.substr(messages::DATALEN));
+}
+
+TEST_F(TestTftpStatic, SendNext_ExhaustsTheSourceAfterTheFinalBlock)
+{
+  session_t session;
+  const auto test_file = create_test_file("short");
+
+  session.state.file = std::make_shared<std::fstream>(
+      test_file, std::ios::in | std::ios::binary);
+  session.state.mode = OCTET;
+  session.state.block_num = 0;
+  session.state.buffer.resize(sizeof(messages::data));
+
+  const auto result = send_next(&session);
+
+  EXPECT_EQ(result, 0);
+  EXPECT_TRUE(session.state.chunk == std::default_sentinel);
+  EXPECT_FALSE(session.state.advance_pending);
+  EXPECT_FALSE(session.state.read_pending());
+}
+
+TEST_F(TestTftpStatic, SendNext_DefersTheAdvanceUntilTheFrameIsSent)
+{
+  session_t session;
+  const std::string content(1024, 'C');
+  const auto test_file = create_test_file(content);
+
+  session.state.file = std::make_shared<std::fstream>(
+      test_file, std::ios::in | std::ios::binary);
+  session.state.mode = OCTET;
+  session.state.block_num = 0;
+  session.state.buffer.resize(sizeof(messages::data));
+
+  // A full block leaves the cursor on the adopted block; the advance
+  // waits until the caller reports the frame handed to the socket.
+  auto result = send_next(&session);
+  EXPECT_EQ(result, 0);
+  EXPECT_TRUE(session.state.advance_pending);
+
+  session.state.advance_read();
+  EXPECT_FALSE(session.state.advance_pending);
+
+  // The advance runs at most once per adopted block.
+  session.state.advance_read();
+
+  result = send_next(&session);
+  EXPECT_EQ(result, 0);
+  EXPECT_EQ(session.state.block_num, 2);
+  const auto data_content =
+      std::string(session.state.buffer.begin() + sizeof(messages::data),
+                  session.state.buffer.end());
+  EXPECT_EQ(data_content, content.substr(messages::DATALEN));
+}
+
 // NOLINTEND
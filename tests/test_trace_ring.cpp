@@ -0,0 +1,80 @@
+/* Copyright (C) 2025 Kevin Exton (kevin.exton@pm.me)
+ *
+ * tftp is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * tftp is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with tftp.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+// NOLINTBEGIN
+// Force the real ring regardless of how the build was configured; the
+// stub variant has nothing worth testing.
+#define TFTP_ENABLE_TRACE
+#include "tftp/detail/trace_ring.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace tftp::detail;
+
+TEST(TraceRingTest, StartsEmpty)
+{
+  trace_ring trace;
+
+  EXPECT_TRUE(trace.snapshot().empty());
+}
+
+TEST(TraceRingTest, RecordsEventsInOrder)
+{
+  trace_ring trace;
+
+  trace.record(4, 1);
+  trace.record(3, 2);
+  trace.record(4, 2, trace_ring::FLAG_RETRANSMIT);
+
+  const auto events = trace.snapshot();
+  ASSERT_EQ(events.size(), 3U);
+  EXPECT_EQ(events[0].opc, 4);
+  EXPECT_EQ(events[0].block, 1);
+  EXPECT_EQ(events[0].flags, 0);
+  EXPECT_EQ(events[1].opc, 3);
+  EXPECT_EQ(events[1].block, 2);
+  EXPECT_EQ(events[2].opc, 4);
+  EXPECT_EQ(events[2].block, 2);
+  EXPECT_EQ(events[2].flags, trace_ring::FLAG_RETRANSMIT);
+}
+
+TEST(TraceRingTest, OverwritesTheOldestEventsWhenFull)
+{
+  trace_ring trace;
+
+  const auto total = trace_ring::CAPACITY + 10;
+  for (auto i = 0UL; i < total; ++i)
+    trace.record(4, static_cast<std::uint16_t>(i));
+
+  const auto events = trace.snapshot();
+  ASSERT_EQ(events.size(), trace_ring::CAPACITY);
+  EXPECT_EQ(events.front().block, static_cast<std::uint16_t>(total - trace_ring::CAPACITY));
+  EXPECT_EQ(events.back().block, static_cast<std::uint16_t>(total - 1));
+}
+
+TEST(TraceRingTest, TimestampsNeverRunBackwards)
+{
+  trace_ring trace;
+
+  for (int i = 0; i < 100; ++i)
+    trace.record(3, static_cast<std::uint16_t>(i));
+
+  const auto events = trace.snapshot();
+  ASSERT_EQ(events.size(), 100U);
+  for (auto i = 1UL; i < events.size(); ++i)
+    EXPECT_GE(events[i].time_ns, events[i - 1].time_ns);
+}
+// NOLINTEND